@@ -0,0 +1,663 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A bounding volume hierarchy over an array of 3D boxes
+//
+
+#ifndef INCLUDED_IMATHBVH_H
+#define INCLUDED_IMATHBVH_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathBox.h"
+#include "ImathBoxAlgo.h"
+#include "ImathFrustumTest.h"
+#include "ImathLine.h"
+#include "ImathVec.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The BVH class is a bounding volume hierarchy over an array of 3D
+/// boxes, the "primitives". It answers ray, box, point and frustum
+/// queries with the indices of the primitives that satisfy them,
+/// testing only the primitives in the subtrees whose bounds are hit,
+/// rather than every primitive.
+///
+/// The hierarchy is a binary tree built top-down with the surface
+/// area heuristic, evaluated over 16 bins along the longest axis of
+/// the primitive centroids. The nodes are stored in a single array,
+/// with the two children of a node stored next to each other, and
+/// the primitive boxes are copied in the order of the leaves, so
+/// that traversal touches contiguous memory.
+///
+/// The results of the queries are the same as testing every
+/// primitive with `intersects (box, ray)`, `Box::intersects (box)`,
+/// `Box::intersects (point)` or `FrustumTest::isVisible (box)`, in an
+/// unspecified order.
+///
+/// A BVH does not refer to the array it was built from; it must be
+/// rebuilt when the boxes change.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE BVH
+{
+  public:
+
+    /// @{
+    /// @name Constructors
+
+    /// An empty hierarchy
+    BVH() noexcept;
+
+    /// Build the hierarchy over the `n` boxes `boxes[i]`, with at
+    /// most `maxLeafSize` primitives per leaf where possible.
+    BVH (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize = 4);
+
+    /// @}
+
+    /// @{
+    /// @name Building
+
+    /// Rebuild the hierarchy over the `n` boxes `boxes[i]`, with at
+    /// most `maxLeafSize` primitives per leaf where possible.
+    void build (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize = 4);
+
+    /// Return the number of primitives
+    size_t size() const noexcept;
+
+    /// Return the number of nodes
+    size_t numNodes() const noexcept;
+
+    /// Return the bounds of all the primitives
+    Box<Vec3<T>> bounds() const noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Queries
+    ///
+    /// The queries append the indices of the matching primitives to
+    /// `result`, and return the number of indices appended.
+
+    /// Find the primitives intersected by the ray `ray`.
+    size_t findIntersecting (const Line3<T>& ray, std::vector<int>& result) const;
+
+    /// Find the primitives that intersect the box `box`.
+    size_t findIntersecting (const Box<Vec3<T>>& box, std::vector<int>& result) const;
+
+    /// Find the primitives that contain the point `point`.
+    size_t findContaining (const Vec3<T>& point, std::vector<int>& result) const;
+
+    /// Find the primitives that are visible in the frustum of
+    /// `frustum`. The planes that contain a node are not tested
+    /// again in its subtree, and the primitives of a node inside the
+    /// frustum are found without further tests. A primitive that
+    /// touches a plane of the frustum to within rounding error may be
+    /// classified differently than by testing it alone.
+    size_t findVisible (const FrustumTest<T>& frustum, std::vector<int>& result) const;
+
+    /// Return the index of the primitive that the ray `ray` enters
+    /// first, or -1 if the ray intersects no primitive. If the ray
+    /// starts inside a primitive, that primitive is entered at the
+    /// ray's origin. The distance along the ray to the entry point,
+    /// measured in units of the ray direction's length, is returned
+    /// in `t`.
+    int findClosest (const Line3<T>& ray, T& t) const noexcept;
+
+    /// @}
+
+  private:
+
+    //
+    // An interior node has count == 0, and its children are nodes
+    // offset and offset + 1. A leaf holds the count primitives
+    // starting at offset in _indices and _boxes.
+    //
+
+    struct Node
+    {
+        Box<Vec3<T>> bounds;
+        int offset;
+        int count;
+    };
+
+    //
+    // Deeper subtrees are split at the median, which bounds the
+    // depth of the tree and the size of the traversal stacks.
+    //
+
+    static const int _maxSahDepth   = 64;
+    static const int _maxStackDepth = 128;
+
+    bool hitsNode (const Node& node,
+                   const Vec3<T>& pos,
+                   const Vec3<T>& invDir,
+                   T tMax,
+                   T& tEntry) const noexcept;
+
+    std::vector<Node> _nodes;
+    std::vector<int> _indices;
+    std::vector<Box<Vec3<T>>> _boxes;
+};
+
+/// BVH of type float
+typedef BVH<float> BVHf;
+
+/// BVH of type double
+typedef BVH<double> BVHd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T> inline BVH<T>::BVH() noexcept
+{
+    // empty
+}
+
+template <class T> inline BVH<T>::BVH (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize)
+{
+    build (boxes, n, maxLeafSize);
+}
+
+template <class T>
+inline size_t
+BVH<T>::size() const noexcept
+{
+    return _indices.size();
+}
+
+template <class T>
+inline size_t
+BVH<T>::numNodes() const noexcept
+{
+    return _nodes.size();
+}
+
+template <class T>
+inline Box<Vec3<T>>
+BVH<T>::bounds() const noexcept
+{
+    return _nodes.empty() ? Box<Vec3<T>>() : _nodes[0].bounds;
+}
+
+template <class T>
+void
+BVH<T>::build (const Box<Vec3<T>>* boxes, size_t n, int maxLeafSize)
+{
+    _nodes.clear();
+    _indices.clear();
+    _boxes.clear();
+
+    if (n == 0)
+        return;
+
+    if (maxLeafSize < 1)
+        maxLeafSize = 1;
+
+    //
+    // The primitives are partitioned in place, as records holding
+    // their boxes and centroids, so that each split reads and writes
+    // contiguous memory.
+    //
+
+    struct Primitive
+    {
+        Box<Vec3<T>> box;
+        Vec3<T> centroid;
+        int index;
+    };
+
+    std::vector<Primitive> primitives (n);
+
+    Node root;
+    root.offset = 0;
+    root.count  = int (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        primitives[i].box      = boxes[i];
+        primitives[i].centroid = (boxes[i].min + boxes[i].max) * T (0.5);
+        primitives[i].index    = int (i);
+        root.bounds.extendBy (boxes[i]);
+    }
+
+    //
+    // A node is created as a leaf holding a range of primitives, and
+    // split later, if it holds too many. The stack holds the nodes
+    // to be split, and their depths.
+    //
+
+    _nodes.reserve (2 * n / maxLeafSize + 1);
+    _nodes.push_back (root);
+
+    std::vector<std::pair<int, int>> stack (1, std::make_pair (0, 0));
+
+    const int numBins = 16;
+
+    while (!stack.empty())
+    {
+        int nodeIndex = stack.back().first;
+        int depth     = stack.back().second;
+        stack.pop_back();
+
+        int first = _nodes[nodeIndex].offset;
+        int count = _nodes[nodeIndex].count;
+
+        if (count <= maxLeafSize)
+            continue;
+
+        Primitive* begin = &primitives[first];
+        Primitive* end   = begin + count;
+        Primitive* mid   = begin;
+
+        Box<Vec3<T>> centroidBounds;
+
+        for (Primitive* p = begin; p < end; ++p)
+            centroidBounds.extendBy (p->centroid);
+
+        int axis = centroidBounds.majorAxis();
+        T cmin   = centroidBounds.min[axis];
+        T extent = centroidBounds.max[axis] - cmin;
+
+        if (!(extent > 0))
+            continue; // all centroids coincide: keep one leaf
+
+        Node children[2];
+
+        if (depth < _maxSahDepth)
+        {
+            //
+            // Bin the primitives by centroid, and choose the split
+            // between bins with the lowest surface area cost. The
+            // bounds of the children are the unions of the bounds
+            // of their bins.
+            //
+
+            Box<Vec3<T>> binBounds[numBins];
+            int binCounts[numBins] = { 0 };
+            T scale                = numBins / extent;
+
+            auto binOf = [&] (const Primitive& p) {
+                int b = int ((p.centroid[axis] - cmin) * scale);
+                return b < numBins ? b : numBins - 1;
+            };
+
+            for (Primitive* p = begin; p < end; ++p)
+            {
+                int b = binOf (*p);
+                binCounts[b]++;
+                binBounds[b].extendBy (p->box);
+            }
+
+            Box<Vec3<T>> rightBounds[numBins];
+            T rightCost[numBins];
+            Box<Vec3<T>> right;
+            int rightCount = 0;
+
+            for (int b = numBins - 1; b > 0; --b)
+            {
+                right.extendBy (binBounds[b]);
+                rightCount += binCounts[b];
+                rightBounds[b] = right;
+
+                Vec3<T> s    = right.size();
+                rightCost[b] = rightCount * (s.x * s.y + s.y * s.z + s.z * s.x);
+            }
+
+            Box<Vec3<T>> left;
+            int leftCount = 0;
+            int bestSplit = 0;
+            T bestCost    = std::numeric_limits<T>::max();
+
+            for (int b = 1; b < numBins; ++b)
+            {
+                left.extendBy (binBounds[b - 1]);
+                leftCount += binCounts[b - 1];
+
+                Vec3<T> s = left.size();
+                T cost    = leftCount * (s.x * s.y + s.y * s.z + s.z * s.x) + rightCost[b];
+
+                if (leftCount > 0 && leftCount < count && cost < bestCost)
+                {
+                    bestCost           = cost;
+                    bestSplit          = b;
+                    children[0].bounds = left;
+                    children[1].bounds = rightBounds[b];
+                }
+            }
+
+            if (bestSplit > 0)
+            {
+                mid = std::partition (begin, end, [&] (const Primitive& p) {
+                    return binOf (p) < bestSplit;
+                });
+            }
+        }
+
+        if (mid == begin || mid == end)
+        {
+            //
+            // Split at the median centroid.
+            //
+
+            mid = begin + count / 2;
+
+            std::nth_element (begin, mid, end, [axis] (const Primitive& p, const Primitive& q) {
+                return p.centroid[axis] < q.centroid[axis];
+            });
+
+            children[0].bounds = children[1].bounds = Box<Vec3<T>>();
+
+            for (Primitive* p = begin; p < end; ++p)
+                children[p < mid ? 0 : 1].bounds.extendBy (p->box);
+        }
+
+        children[0].offset = first;
+        children[0].count  = int (mid - begin);
+        children[1].offset = first + children[0].count;
+        children[1].count  = count - children[0].count;
+
+        int childIndex = int (_nodes.size());
+
+        _nodes[nodeIndex].offset = childIndex;
+        _nodes[nodeIndex].count  = 0;
+        _nodes.push_back (children[0]);
+        _nodes.push_back (children[1]);
+
+        stack.push_back (std::make_pair (childIndex, depth + 1));
+        stack.push_back (std::make_pair (childIndex + 1, depth + 1));
+    }
+
+    _indices.resize (n);
+    _boxes.resize (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        _indices[i] = primitives[i].index;
+        _boxes[i]   = primitives[i].box;
+    }
+}
+
+template <class T>
+inline bool
+BVH<T>::hitsNode (const Node& node,
+                  const Vec3<T>& pos,
+                  const Vec3<T>& invDir,
+                  T tMax,
+                  T& tEntry) const noexcept
+{
+    //
+    // The slab test, limited to the part of the ray before tMax. Its
+    // tolerance keeps it from rejecting a node that the exact test in
+    // intersects (box, ray) would accept.
+    //
+
+    return intersects (node.bounds, pos, invDir, tEntry) && tEntry <= tMax * slabTolerance<T>();
+}
+
+template <class T>
+size_t
+BVH<T>::findIntersecting (const Line3<T>& ray, std::vector<int>& result) const
+{
+    size_t numFound = 0;
+
+    if (_nodes.empty())
+        return numFound;
+
+    Vec3<T> invDir (T (1) / ray.dir.x, T (1) / ray.dir.y, T (1) / ray.dir.z);
+    T tMax = std::numeric_limits<T>::infinity();
+
+    int stack[_maxStackDepth];
+    int top      = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+        T tEntry;
+
+        if (!hitsNode (node, ray.pos, invDir, tMax, tEntry))
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.offset + 1;
+            stack[top++] = node.offset;
+            continue;
+        }
+
+        for (int i = node.offset; i < node.offset + node.count; ++i)
+        {
+            if (intersects (_boxes[i], ray))
+            {
+                result.push_back (_indices[i]);
+                ++numFound;
+            }
+        }
+    }
+
+    return numFound;
+}
+
+template <class T>
+size_t
+BVH<T>::findIntersecting (const Box<Vec3<T>>& box, std::vector<int>& result) const
+{
+    size_t numFound = 0;
+
+    if (_nodes.empty())
+        return numFound;
+
+    int stack[_maxStackDepth];
+    int top      = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        if (!node.bounds.intersects (box))
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.offset + 1;
+            stack[top++] = node.offset;
+            continue;
+        }
+
+        for (int i = node.offset; i < node.offset + node.count; ++i)
+        {
+            if (_boxes[i].intersects (box))
+            {
+                result.push_back (_indices[i]);
+                ++numFound;
+            }
+        }
+    }
+
+    return numFound;
+}
+
+template <class T>
+size_t
+BVH<T>::findContaining (const Vec3<T>& point, std::vector<int>& result) const
+{
+    size_t numFound = 0;
+
+    if (_nodes.empty())
+        return numFound;
+
+    int stack[_maxStackDepth];
+    int top      = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+
+        if (!node.bounds.intersects (point))
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.offset + 1;
+            stack[top++] = node.offset;
+            continue;
+        }
+
+        for (int i = node.offset; i < node.offset + node.count; ++i)
+        {
+            if (_boxes[i].intersects (point))
+            {
+                result.push_back (_indices[i]);
+                ++numFound;
+            }
+        }
+    }
+
+    return numFound;
+}
+
+template <class T>
+int
+BVH<T>::findClosest (const Line3<T>& ray, T& t) const noexcept
+{
+    int closest = -1;
+
+    if (_nodes.empty())
+        return closest;
+
+    Vec3<T> invDir (T (1) / ray.dir.x, T (1) / ray.dir.y, T (1) / ray.dir.z);
+    T tMax = std::numeric_limits<T>::infinity();
+    T dir2 = ray.dir.length2();
+
+    int stack[_maxStackDepth];
+    int top      = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const Node& node = _nodes[stack[--top]];
+        T tEntry;
+
+        if (!hitsNode (node, ray.pos, invDir, tMax, tEntry))
+            continue;
+
+        if (node.count == 0)
+        {
+            //
+            // Visit the nearer child first.
+            //
+
+            T t0, t1;
+            bool hit0 = hitsNode (_nodes[node.offset], ray.pos, invDir, tMax, t0);
+            bool hit1 = hitsNode (_nodes[node.offset + 1], ray.pos, invDir, tMax, t1);
+
+            if (hit0 && hit1)
+            {
+                bool firstNearer = t0 <= t1;
+                stack[top++]     = node.offset + (firstNearer ? 1 : 0);
+                stack[top++]     = node.offset + (firstNearer ? 0 : 1);
+            }
+            else if (hit0)
+            {
+                stack[top++] = node.offset;
+            }
+            else if (hit1)
+            {
+                stack[top++] = node.offset + 1;
+            }
+
+            continue;
+        }
+
+        for (int i = node.offset; i < node.offset + node.count; ++i)
+        {
+            Vec3<T> ip (T (0));
+
+            if (intersects (_boxes[i], ray, ip))
+            {
+                T d = ((ip - ray.pos) ^ ray.dir) / dir2;
+
+                if (closest < 0 || d < tMax || (d == tMax && _indices[i] < closest))
+                {
+                    tMax    = d;
+                    closest = _indices[i];
+                }
+            }
+        }
+    }
+
+    t = tMax;
+    return closest;
+}
+
+template <class T>
+size_t
+BVH<T>::findVisible (const FrustumTest<T>& frustum, std::vector<int>& result) const
+{
+    size_t numFound = 0;
+
+    if (_nodes.empty())
+        return numFound;
+
+    //
+    // Each node on the stack carries the planes that its parent
+    // straddles; the others contain it. The plane that culled the
+    // last node is tested first.
+    //
+
+    int stack[_maxStackDepth];
+    unsigned int planeMasks[_maxStackDepth];
+    int top         = 0;
+    int lastPlane   = 0;
+    planeMasks[top] = 0x3f;
+    stack[top++]    = 0;
+
+    while (top > 0)
+    {
+        --top;
+        const Node& node       = _nodes[stack[top]];
+        unsigned int planeMask = planeMasks[top];
+
+        if (planeMask && !frustum.isVisible (node.bounds, planeMask, lastPlane))
+            continue;
+
+        if (node.count == 0)
+        {
+            planeMasks[top] = planeMask;
+            stack[top++]    = node.offset + 1;
+            planeMasks[top] = planeMask;
+            stack[top++]    = node.offset;
+            continue;
+        }
+
+        for (int i = node.offset; i < node.offset + node.count; ++i)
+        {
+            unsigned int mask = planeMask;
+
+            if (mask ? frustum.isVisible (_boxes[i], mask, lastPlane) : !_boxes[i].isEmpty())
+            {
+                result.push_back (_indices[i]);
+                ++numFound;
+            }
+        }
+    }
+
+    return numFound;
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHBVH_H
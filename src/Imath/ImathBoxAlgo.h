@@ -16,6 +16,9 @@
 #include "ImathLineAlgo.h"
 #include "ImathMatrix.h"
 #include "ImathPlane.h"
+#include "ImathPlatform.h"
+
+#include <limits>
 
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
@@ -97,6 +100,98 @@ closestPointOnBox (const Vec3<T>& p, const Box<Vec3<T>>& box) noexcept
     return q;
 }
 
+///
+/// Set `(qx[i], qy[i], qz[i])` to the point on the surface of `box`
+/// that is closest to the point `(x[i], y[i], z[i])`, for each of the
+/// `n` points, as `closestPointOnBox (p, box)` does.
+///
+
+template <class T>
+void
+closestPointOnBox (const T* IMATH_RESTRICT x,
+                   const T* IMATH_RESTRICT y,
+                   const T* IMATH_RESTRICT z,
+                   size_t n,
+                   const Box<Vec3<T>>& box,
+                   T* IMATH_RESTRICT qx,
+                   T* IMATH_RESTRICT qy,
+                   T* IMATH_RESTRICT qz) noexcept
+{
+    if (box.isEmpty())
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            qx[i] = x[i];
+            qy[i] = y[i];
+            qz[i] = z[i];
+        }
+
+        return;
+    }
+
+    const Vec3<T> lo = box.min;
+    const Vec3<T> hi = box.max;
+
+    //
+    // The closest points are computed in blocks, into local arrays
+    // that cannot alias the points, and then copied out. The choice
+    // of face for a point inside the box is made with selects rather
+    // than branches.
+    //
+
+    const size_t blockSize = 64;
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        T q[3][blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            T px = x[b + i];
+            T py = y[b + i];
+            T pz = z[b + i];
+
+            T cx = px < lo.x ? lo.x : px;
+            T cy = py < lo.y ? lo.y : py;
+            T cz = pz < lo.z ? lo.z : pz;
+
+            cx = cx > hi.x ? hi.x : cx;
+            cy = cy > hi.y ? hi.y : cy;
+            cz = cz > hi.z ? hi.z : cz;
+
+            bool inside = (cx == px) & (cy == py) & (cz == pz);
+
+            T d1x = px - lo.x, d2x = hi.x - px;
+            T d1y = py - lo.y, d2y = hi.y - py;
+            T d1z = pz - lo.z, d2z = hi.z - pz;
+
+            T dx = d1x < d2x ? d1x : d2x;
+            T dy = d1y < d2y ? d1y : d2y;
+            T dz = d1z < d2z ? d1z : d2z;
+
+            bool onX = inside & (dx < dy) & (dx < dz);
+            bool onY = inside & !onX & (dy < dz);
+            bool onZ = inside & !onX & !onY;
+
+            T fx = d1x < d2x ? lo.x : hi.x;
+            T fy = d1y < d2y ? lo.y : hi.y;
+            T fz = d1z < d2z ? lo.z : hi.z;
+
+            q[0][i] = onX ? fx : cx;
+            q[1][i] = onY ? fy : cy;
+            q[2][i] = onZ ? fz : cz;
+        }
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            qx[b + i] = q[0][i];
+            qy[b + i] = q[1][i];
+            qz[b + i] = q[2][i];
+        }
+    }
+}
+
 ///
 /// Transform a 3D box by a matrix, and compute a new box that
 /// tightly encloses the transformed box. Return the transformed box.
@@ -354,6 +449,271 @@ affineTransform (const Box<Vec3<S>>& box, const Matrix44<T>& m, Box<Vec3<S>>& re
     }
 }
 
+/// @cond Doxygen_Suppress
+//
+// The batched transforms process the boxes in blocks, transposed
+// into separate arrays of the components of their corners, so that
+// the transforms vectorize across boxes.
+//
+
+template <class S> struct BoxBlock
+{
+    static const size_t size = 64;
+
+    //
+    // in[0..2][i] and in[3..5][i] are the minimum and maximum of box
+    // i; out holds the transformed boxes.
+    //
+
+    S in[6][size];
+    S out[6][size];
+
+    void load (const Box<Vec3<S>>* boxes, size_t n) noexcept
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                in[j][i]     = boxes[i].min[j];
+                in[j + 3][i] = boxes[i].max[j];
+            }
+        }
+    }
+
+    Box<Vec3<S>> input (size_t i) const noexcept
+    {
+        return Box<Vec3<S>> (Vec3<S> (in[0][i], in[1][i], in[2][i]),
+                             Vec3<S> (in[3][i], in[4][i], in[5][i]));
+    }
+
+    Box<Vec3<S>> output (size_t i) const noexcept
+    {
+        return Box<Vec3<S>> (Vec3<S> (out[0][i], out[1][i], out[2][i]),
+                             Vec3<S> (out[3][i], out[4][i], out[5][i]));
+    }
+
+    //
+    // Transform the n boxes by the affine matrix m, with Arvo's
+    // method in its center and extent form: the center of each box
+    // is transformed as a point, and its half-extents by the
+    // absolute values of the upper-left 3x3 elements of m. Return
+    // whether any of the boxes may be empty or infinite; those are
+    // not transformed correctly, and must be redone one at a time.
+    //
+
+    template <class T> bool affineTransform (const Matrix44<T>& m, size_t n) noexcept
+    {
+        const S m00 = S (m[0][0]), m01 = S (m[0][1]), m02 = S (m[0][2]);
+        const S m10 = S (m[1][0]), m11 = S (m[1][1]), m12 = S (m[1][2]);
+        const S m20 = S (m[2][0]), m21 = S (m[2][1]), m22 = S (m[2][2]);
+        const S m30 = S (m[3][0]), m31 = S (m[3][1]), m32 = S (m[3][2]);
+
+        const S a00 = std::abs (m00), a01 = std::abs (m01), a02 = std::abs (m02);
+        const S a10 = std::abs (m10), a11 = std::abs (m11), a12 = std::abs (m12);
+        const S a20 = std::abs (m20), a21 = std::abs (m21), a22 = std::abs (m22);
+
+        const S lowest = std::numeric_limits<S>::lowest();
+        int special    = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            S x0 = in[0][i], y0 = in[1][i], z0 = in[2][i];
+            S x1 = in[3][i], y1 = in[4][i], z1 = in[5][i];
+
+            S cx = (x0 + x1) * S (0.5);
+            S cy = (y0 + y1) * S (0.5);
+            S cz = (z0 + z1) * S (0.5);
+            S ex = (x1 - x0) * S (0.5);
+            S ey = (y1 - y0) * S (0.5);
+            S ez = (z1 - z0) * S (0.5);
+
+            S nx = cx * m00 + cy * m10 + cz * m20 + m30;
+            S ny = cx * m01 + cy * m11 + cz * m21 + m31;
+            S nz = cx * m02 + cy * m12 + cz * m22 + m32;
+            S hx = ex * a00 + ey * a10 + ez * a20;
+            S hy = ex * a01 + ey * a11 + ez * a21;
+            S hz = ex * a02 + ey * a12 + ez * a22;
+
+            out[0][i] = nx - hx;
+            out[1][i] = ny - hy;
+            out[2][i] = nz - hz;
+            out[3][i] = nx + hx;
+            out[4][i] = ny + hy;
+            out[5][i] = nz + hz;
+
+            special |= (x0 > x1) | (y0 > y1) | (z0 > z1) | (x0 == lowest);
+        }
+
+        return special != 0;
+    }
+};
+/// @endcond
+
+///
+/// Transform the `n` 3D boxes `boxes[i]` by the matrix `m`, as
+/// `transform (boxes[i], m, result[i])` does, and return the
+/// transformed boxes in `result`, which may be the same array as
+/// `boxes`.
+///
+/// If `m` is affine, the boxes are transformed in blocks with James
+/// Arvo's method, in the center and extent form that vectorizes
+/// across boxes, which may round differently from the single box
+/// transform(). Otherwise the boxes are transformed one at a time.
+///
+
+template <class S, class T>
+void
+transform (const Box<Vec3<S>>* boxes, size_t n, const Matrix44<T>& m, Box<Vec3<S>>* result) noexcept
+{
+    if (m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1)
+    {
+        affineTransform (boxes, n, m, result);
+        return;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        result[i] = transform (boxes[i], m);
+}
+
+///
+/// Transform the `n` 3D boxes `boxes[i]` by the matrix `m`, whose
+/// rightmost column is `(0 0 0 1)`, as `affineTransform (boxes[i],
+/// m, result[i])` does, and return the transformed boxes in
+/// `result`, which may be the same array as `boxes`.
+///
+/// The boxes are transformed in blocks, as by the batched
+/// transform().
+///
+
+template <class S, class T>
+void
+affineTransform (const Box<Vec3<S>>* boxes, size_t n, const Matrix44<T>& m, Box<Vec3<S>>* result) noexcept
+{
+    BoxBlock<S> block;
+
+    for (size_t start = 0; start < n; start += block.size)
+    {
+        size_t k = n - start < block.size ? n - start : block.size;
+
+        block.load (boxes + start, k);
+
+        if (block.affineTransform (m, k))
+        {
+            for (size_t i = 0; i < k; ++i)
+                result[start + i] = affineTransform (block.input (i), m);
+        }
+        else
+        {
+            for (size_t i = 0; i < k; ++i)
+                result[start + i] = block.output (i);
+        }
+    }
+}
+
+///
+/// Return the union of the `n` 3D boxes `boxes[i]` transformed by
+/// the matrix `m`: the box computed by calling `extendBy
+/// (transform (boxes[i], m))` on an empty box for each of the boxes,
+/// without storing the transformed boxes. If `m` is affine, the
+/// boxes are transformed in blocks, as by the batched transform().
+///
+
+template <class S, class T>
+Box<Vec3<S>>
+boundsOf (const Box<Vec3<S>>* boxes, size_t n, const Matrix44<T>& m) noexcept
+{
+    Box<Vec3<S>> bounds;
+
+    if (!(m[0][3] == 0 && m[1][3] == 0 && m[2][3] == 0 && m[3][3] == 1))
+    {
+        for (size_t i = 0; i < n; ++i)
+            bounds.extendBy (transform (boxes[i], m));
+
+        return bounds;
+    }
+
+    //
+    // The minimum and maximum of each lane of the blocks are kept
+    // separately, and combined at the end.
+    //
+
+    BoxBlock<S> block;
+    S lanes[6][BoxBlock<S>::size];
+
+    for (size_t i = 0; i < block.size; ++i)
+    {
+        lanes[0][i] = lanes[1][i] = lanes[2][i] = std::numeric_limits<S>::max();
+        lanes[3][i] = lanes[4][i] = lanes[5][i] = std::numeric_limits<S>::lowest();
+    }
+
+    for (size_t start = 0; start < n; start += block.size)
+    {
+        size_t k = n - start < block.size ? n - start : block.size;
+
+        block.load (boxes + start, k);
+
+        if (block.affineTransform (m, k))
+        {
+            for (size_t i = 0; i < k; ++i)
+                bounds.extendBy (affineTransform (block.input (i), m));
+
+            continue;
+        }
+
+        for (int j = 0; j < 3; ++j)
+        {
+            for (size_t i = 0; i < k; ++i)
+            {
+                lanes[j][i]     = block.out[j][i] < lanes[j][i] ? block.out[j][i] : lanes[j][i];
+                lanes[j + 3][i] = block.out[j + 3][i] > lanes[j + 3][i] ? block.out[j + 3][i] : lanes[j + 3][i];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < block.size; ++i)
+    {
+        bounds.extendBy (Box<Vec3<S>> (Vec3<S> (lanes[0][i], lanes[1][i], lanes[2][i]),
+                                       Vec3<S> (lanes[3][i], lanes[4][i], lanes[5][i])));
+    }
+
+    return bounds;
+}
+
+///
+/// Transform each of the `n` 3D boxes `boxes[i]` by its own matrix
+/// `m[i]`, whose rightmost column is `(0 0 0 1)`, as
+/// `affineTransform (boxes[i], m[i], result[i])` does, and return
+/// the transformed boxes in `result`, which may be the same array as
+/// `boxes`.
+///
+
+template <class S, class T>
+void
+affineTransform (const Box<Vec3<S>>* boxes, const Matrix44<T>* m, size_t n, Box<Vec3<S>>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = affineTransform (boxes[i], m[i]);
+}
+
+///
+/// Return the union of the `n` 3D boxes `boxes[i]`, each transformed
+/// by its own matrix `m[i]`, whose rightmost column is `(0 0 0 1)`:
+/// for example, the bounds of the children of a node of a scene
+/// graph, in the space of the node.
+///
+
+template <class S, class T>
+Box<Vec3<S>>
+boundsOf (const Box<Vec3<S>>* boxes, const Matrix44<T>* m, size_t n) noexcept
+{
+    Box<Vec3<S>> bounds;
+
+    for (size_t i = 0; i < n; ++i)
+        bounds.extendBy (affineTransform (boxes[i], m[i]));
+
+    return bounds;
+}
+
 ///
 /// Compute the points where a ray, `r`, enters and exits a 3D box, `b`:
 ///
@@ -903,6 +1263,396 @@ intersects (const Box<Vec3<T>>& box, const Line3<T>& ray) noexcept
     return intersects (box, ray, ignored);
 }
 
+/// @cond Doxygen_Suppress
+//
+// One axis of the slab test: narrow the interval [tNear, tFar] of
+// ray parameters to the part where the ray lies between the planes
+// lo and hi. The planes are ordered by the sign of the reciprocal
+// direction, rather than by comparing their distances, so that the
+// NaN produced where a ray parallel to the planes starts on one of
+// them (0 * infinity) lands in the comparisons that ignore it.
+//
+
+template <class T>
+IMATH_HOSTDEVICE inline void
+slab (T lo, T hi, T pos, T invDir, T& tNear, T& tFar) noexcept
+{
+    T t0 = (lo - pos) * invDir;
+    T t1 = (hi - pos) * invDir;
+    T n  = invDir < 0 ? t1 : t0;
+    T f  = invDir < 0 ? t0 : t1;
+
+    tNear = n > tNear ? n : tNear;
+    tFar  = f < tFar ? f : tFar;
+}
+
+//
+// The slab test accepts intervals that are empty by a few ulps, so
+// that it never rejects a ray that grazes an edge of the box.
+//
+
+template <class T>
+IMATH_HOSTDEVICE constexpr inline T
+slabTolerance() noexcept
+{
+    return 1 + 4 * std::numeric_limits<T>::epsilon();
+}
+/// @endcond
+
+///
+/// Return whether the ray with origin `pos` and reciprocal direction
+/// `invDir` (that is, `1 / dir` per component, which is infinite
+/// for a zero component) intersects the 3D box `box`, and return in
+/// `tEntry` the ray parameter where the ray enters the box, which
+/// is 0 if the ray starts inside the box. The entry point is `pos +
+/// tEntry * dir`.
+///
+/// This is the branch-free slab test. It agrees with `intersects
+/// (box, ray)`, except that rays that graze the box within a few
+/// ulps may be reported as intersecting it. Its advantage is that
+/// the reciprocal direction is computed once, and reused for every
+/// box the ray is tested against.
+///
+
+template <class T>
+IMATH_HOSTDEVICE inline bool
+intersects (const Box<Vec3<T>>& box, const Vec3<T>& pos, const Vec3<T>& invDir, T& tEntry) noexcept
+{
+    T tNear = 0;
+    T tFar  = std::numeric_limits<T>::infinity();
+
+    slab (box.min.x, box.max.x, pos.x, invDir.x, tNear, tFar);
+    slab (box.min.y, box.max.y, pos.y, invDir.y, tNear, tFar);
+    slab (box.min.z, box.max.z, pos.z, invDir.z, tNear, tFar);
+
+    tEntry = tNear;
+    return tNear <= tFar * slabTolerance<T>();
+}
+
+///
+/// Intersect a packet of `n` rays with the 3D box `box`. Ray `i` has
+/// origin `(posX[i], posY[i], posZ[i])` and reciprocal direction
+/// `(invDirX[i], invDirY[i], invDirZ[i])`. Set `hits[i]` to whether
+/// ray `i` intersects the box, as `intersects (box, pos, invDir,
+/// tEntry)` does, and `tEntry[i]` to the ray parameter where the ray
+/// enters the box, or to infinity if it misses. Return the number of
+/// rays that intersect the box.
+///
+/// The rays are processed independently, without branches, so that
+/// the loop vectorizes across rays.
+///
+
+template <class T>
+size_t
+intersects (const Box<Vec3<T>>& box,
+            const T* IMATH_RESTRICT posX,
+            const T* IMATH_RESTRICT posY,
+            const T* IMATH_RESTRICT posZ,
+            const T* IMATH_RESTRICT invDirX,
+            const T* IMATH_RESTRICT invDirY,
+            const T* IMATH_RESTRICT invDirZ,
+            size_t n,
+            bool* IMATH_RESTRICT hits,
+            T* IMATH_RESTRICT tEntry) noexcept
+{
+    const T infinity  = std::numeric_limits<T>::infinity();
+    const T tolerance = slabTolerance<T>();
+    size_t numHits    = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T tNear = 0;
+        T tFar  = infinity;
+
+        slab (box.min.x, box.max.x, posX[i], invDirX[i], tNear, tFar);
+        slab (box.min.y, box.max.y, posY[i], invDirY[i], tNear, tFar);
+        slab (box.min.z, box.max.z, posZ[i], invDirZ[i], tNear, tFar);
+
+        bool hit  = tNear <= tFar * tolerance;
+        hits[i]   = hit;
+        tEntry[i] = hit ? tNear : infinity;
+        numHits += hit;
+    }
+
+    return numHits;
+}
+
+///
+/// Intersect the `n` 3D boxes `boxes[i]` with the ray `ray`. Set
+/// `hits[i]` to whether the ray intersects box `i`, as `intersects
+/// (box, pos, invDir, tEntry)` does, and `tEntry[i]` to the ray
+/// parameter where the ray enters box `i`, or to infinity if it
+/// misses. Since the direction of a `Line3` is normalized, the ray
+/// parameter is the distance from the ray's origin. Return the
+/// number of boxes the ray intersects.
+///
+
+template <class T>
+size_t
+intersects (const Box<Vec3<T>>* IMATH_RESTRICT boxes,
+            size_t n,
+            const Line3<T>& ray,
+            bool* IMATH_RESTRICT hits,
+            T* IMATH_RESTRICT tEntry) noexcept
+{
+    const T infinity  = std::numeric_limits<T>::infinity();
+    const T tolerance = slabTolerance<T>();
+    size_t numHits    = 0;
+
+    const Vec3<T> pos    = ray.pos;
+    const Vec3<T> invDir = Vec3<T> (T (1) / ray.dir.x, T (1) / ray.dir.y, T (1) / ray.dir.z);
+
+    //
+    // The boxes are transposed in blocks into separate arrays of
+    // components, so that the slab test vectorizes across boxes.
+    //
+
+    const size_t block = 64;
+    T minX[block], minY[block], minZ[block], maxX[block], maxY[block], maxZ[block];
+
+    for (size_t start = 0; start < n; start += block)
+    {
+        size_t m = n - start < block ? n - start : block;
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            const Box<Vec3<T>>& box = boxes[start + i];
+
+            minX[i] = box.min.x;
+            minY[i] = box.min.y;
+            minZ[i] = box.min.z;
+            maxX[i] = box.max.x;
+            maxY[i] = box.max.y;
+            maxZ[i] = box.max.z;
+        }
+
+        bool* IMATH_RESTRICT h = hits + start;
+        T* IMATH_RESTRICT t    = tEntry + start;
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            T tNear = 0;
+            T tFar  = infinity;
+
+            slab (minX[i], maxX[i], pos.x, invDir.x, tNear, tFar);
+            slab (minY[i], maxY[i], pos.y, invDir.y, tNear, tFar);
+            slab (minZ[i], maxZ[i], pos.z, invDir.z, tNear, tFar);
+
+            bool hit = tNear <= tFar * tolerance;
+            h[i]     = hit;
+            t[i]     = hit ? tNear : infinity;
+            numHits += hit;
+        }
+    }
+
+    return numHits;
+}
+
+///
+/// Return the index of the one of the `n` 3D boxes `boxes[i]` that is
+/// closest to the point `p`, or -1 if there are no non-empty boxes.
+/// The distance to a box is the distance to its closest point,
+/// `closestPointInBox (p, box)`, which is 0 for a box that contains
+/// `p`; that point is returned in `point`. Of equally close boxes,
+/// the first is returned, and empty boxes are ignored.
+///
+
+template <class T>
+int
+closestBox (const Vec3<T>& p, const Box<Vec3<T>>* boxes, size_t n, Vec3<T>& point) noexcept
+{
+    const T infinity = std::numeric_limits<T>::infinity();
+
+    int nearest = -1;
+    T nearestD2 = infinity;
+
+    //
+    // As in the batched intersects(), the boxes are transposed in
+    // blocks, so that the distances vectorize across boxes.
+    //
+
+    const size_t block = 64;
+    T minX[block], minY[block], minZ[block], maxX[block], maxY[block], maxZ[block];
+    T d2[block];
+
+    for (size_t start = 0; start < n; start += block)
+    {
+        size_t m = n - start < block ? n - start : block;
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            const Box<Vec3<T>>& box = boxes[start + i];
+
+            minX[i] = box.min.x;
+            minY[i] = box.min.y;
+            minZ[i] = box.min.z;
+            maxX[i] = box.max.x;
+            maxY[i] = box.max.y;
+            maxZ[i] = box.max.z;
+        }
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            T dx = p.x < minX[i] ? minX[i] - p.x : (p.x > maxX[i] ? p.x - maxX[i] : T (0));
+            T dy = p.y < minY[i] ? minY[i] - p.y : (p.y > maxY[i] ? p.y - maxY[i] : T (0));
+            T dz = p.z < minZ[i] ? minZ[i] - p.z : (p.z > maxZ[i] ? p.z - maxZ[i] : T (0));
+
+            bool empty = (maxX[i] < minX[i]) | (maxY[i] < minY[i]) | (maxZ[i] < minZ[i]);
+            d2[i]      = empty ? infinity : dx * dx + dy * dy + dz * dz;
+        }
+
+        T blockMin = nearestD2;
+
+        for (size_t i = 0; i < m; ++i)
+            blockMin = d2[i] < blockMin ? d2[i] : blockMin;
+
+        if (blockMin < nearestD2)
+        {
+            for (size_t i = 0; i < m; ++i)
+            {
+                if (d2[i] == blockMin)
+                {
+                    nearest   = int (start + i);
+                    nearestD2 = blockMin;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (nearest >= 0)
+        point = closestPointInBox (p, boxes[nearest]);
+
+    return nearest;
+}
+
+///
+/// Return the bounding box of the `n` points `points[i]` (`Vec2`,
+/// `Vec3`). This is the box computed by calling `extendBy()` on an
+/// empty box for each of the points, but the points are processed
+/// in interleaved groups, with the minimum and maximum of each group
+/// kept in separate lanes, so that the comparisons vectorize rather
+/// than forming a serial dependency.
+///
+
+template <class V>
+Box<V>
+boundsOf (const V* points, size_t n) noexcept
+{
+    typedef typename V::BaseType T;
+
+    //
+    // The components of consecutive points are contiguous, so groups
+    // of eight points are treated as one flat array of components,
+    // with component j of each point landing in lanes j, j + d,
+    // j + 2d, ...
+    //
+
+    const unsigned int d = V::dimensions();
+    const size_t group   = 8;
+    const size_t lanes   = group * V::dimensions();
+
+    T lo[lanes];
+    T hi[lanes];
+
+    for (size_t k = 0; k < lanes; ++k)
+    {
+        lo[k] = V::baseTypeMax();
+        hi[k] = V::baseTypeLowest();
+    }
+
+    size_t i = 0;
+
+    for (; i + group <= n; i += group)
+    {
+        const T* p = &points[i][0];
+
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            lo[k] = p[k] < lo[k] ? p[k] : lo[k];
+            hi[k] = p[k] > hi[k] ? p[k] : hi[k];
+        }
+    }
+
+    Box<V> b;
+
+    for (size_t k = 0; k < lanes; ++k)
+    {
+        if (lo[k] < b.min[k % d])
+            b.min[k % d] = lo[k];
+
+        if (hi[k] > b.max[k % d])
+            b.max[k % d] = hi[k];
+    }
+
+    for (; i < n; ++i)
+        b.extendBy (points[i]);
+
+    return b;
+}
+
+///
+/// Return the bounding box of the `n` points `points[indices[i]]`
+/// (`Vec2`, `Vec3`), as `boundsOf (points, n)` does for a contiguous
+/// array of points.
+///
+
+template <class V>
+Box<V>
+boundsOf (const V* points, const int* indices, size_t n) noexcept
+{
+    typedef typename V::BaseType T;
+
+    const size_t lanes = 8;
+    T lo[V::dimensions()][lanes];
+    T hi[V::dimensions()][lanes];
+
+    for (unsigned int j = 0; j < V::dimensions(); ++j)
+    {
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            lo[j][k] = V::baseTypeMax();
+            hi[j][k] = V::baseTypeLowest();
+        }
+    }
+
+    size_t i = 0;
+
+    for (; i + lanes <= n; i += lanes)
+    {
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            const V& p = points[indices[i + k]];
+
+            for (unsigned int j = 0; j < V::dimensions(); ++j)
+            {
+                T v      = p[j];
+                lo[j][k] = v < lo[j][k] ? v : lo[j][k];
+                hi[j][k] = v > hi[j][k] ? v : hi[j][k];
+            }
+        }
+    }
+
+    Box<V> b;
+
+    for (unsigned int j = 0; j < V::dimensions(); ++j)
+    {
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            if (lo[j][k] < b.min[j])
+                b.min[j] = lo[j][k];
+
+            if (hi[j][k] > b.max[j])
+                b.max[j] = hi[j][k];
+        }
+    }
+
+    for (; i < n; ++i)
+        b.extendBy (points[indices[i]]);
+
+    return b;
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHBOXALGO_H
@@ -10,9 +10,333 @@
 ///
 
 #include "ImathColorAlgo.h"
+#include "ImathPlatform.h"
 
 IMATH_INTERNAL_NAMESPACE_SOURCE_ENTER
 
+namespace
+{
+
+//
+// Branch-free versions of rgb2hsv_d() and hsv2rgb_d(), in float, for
+// up to 64 colors in planar channels. The cases are computed for every
+// color and the results are selected, so that the loops vectorize.
+// The arithmetic and the selects are done in separate loops, through
+// local arrays; otherwise, the compiler may move the arithmetic into
+// the cases, which it then cannot vectorize without -fno-trapping-math.
+//
+
+void
+rgb2hsvKernel (const float* IMATH_RESTRICT r,
+               const float* IMATH_RESTRICT g,
+               const float* IMATH_RESTRICT b,
+               size_t n,
+               float* IMATH_RESTRICT h,
+               float* IMATH_RESTRICT s,
+               float* IMATH_RESTRICT v) noexcept
+{
+    float range[64], divisor[64], hr[64], hrWrapped[64], hg[64], hb[64];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float x = r[i];
+        float y = g[i];
+        float z = b[i];
+
+        float max = x > y ? x : y;
+        max       = max > z ? max : z;
+        float min = x < y ? x : y;
+        min       = min < z ? min : z;
+
+        float diff = max - min;
+
+        range[i]   = diff;
+        divisor[i] = max != 0 ? max : 1.0f;
+        s[i]       = max != 0 ? diff : 0.0f;
+        v[i]       = max;
+    }
+
+    //
+    // The saturation, and the hue in the sextant of each channel, as
+    // if it were the largest channel; only the hue of red can be
+    // negative.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float d = range[i] != 0 ? range[i] : 1.0f;
+
+        s[i]         = s[i] / divisor[i];
+        hr[i]        = (0.0f + (g[i] - b[i]) / d) / 6;
+        hrWrapped[i] = hr[i] + 1.0f;
+        hg[i]        = (2.0f + (b[i] - r[i]) / d) / 6;
+        hb[i]        = (4.0f + (r[i] - g[i]) / d) / 6;
+    }
+
+    //
+    // Select the hue of the largest channel, in the order of
+    // rgb2hsv_d().
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float max = v[i];
+        float red = hr[i] < 0 ? hrWrapped[i] : hr[i];
+
+        float hue = g[i] == max ? hg[i] : hb[i];
+        hue       = r[i] == max ? red : hue;
+        h[i]      = s[i] != 0 ? hue : 0.0f;
+    }
+}
+
+void
+hsv2rgbKernel (const float* IMATH_RESTRICT h,
+               const float* IMATH_RESTRICT s,
+               const float* IMATH_RESTRICT v,
+               size_t n,
+               float* IMATH_RESTRICT r,
+               float* IMATH_RESTRICT g,
+               float* IMATH_RESTRICT b) noexcept
+{
+    float hue[64], clamped[64], sextant[64], p[64], q[64], t[64];
+
+    for (size_t i = 0; i < n; ++i)
+        hue[i] = h[i] * 6;
+
+    //
+    // The sextant is floor (hue), found by truncation of a hue clamped
+    // to the range in which the sextants are told apart; colors
+    // outside of sextants 0 to 5, or with a nan hue, are black, as in
+    // hsv2rgb_d().
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float c = hue[i] >= -1 ? hue[i] : -1.0f;
+        c       = c <= 7 ? c : 7.0f;
+
+        clamped[i] = h[i] == 1 ? 0.0f : c;
+        hue[i]     = h[i] == 1 ? 0.0f : hue[i];
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        int truncated = int (clamped[i]);
+        float floor   = float (truncated - (float (truncated) > clamped[i]));
+        float f       = hue[i] - floor;
+
+        sextant[i] = floor;
+        p[i]       = v[i] * (1 - s[i]);
+        q[i]       = v[i] * (1 - (s[i] * f));
+        t[i]       = v[i] * (1 - (s[i] * (1 - f)));
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        float e  = sextant[i];
+        float vi = v[i];
+        float pi = p[i];
+        float qi = q[i];
+        float ti = t[i];
+
+        float x = 0, y = 0, z = 0;
+
+        x = e == 0 ? vi : x;
+        y = e == 0 ? ti : y;
+        z = e == 0 ? pi : z;
+        x = e == 1 ? qi : x;
+        y = e == 1 ? vi : y;
+        z = e == 1 ? pi : z;
+        x = e == 2 ? pi : x;
+        y = e == 2 ? vi : y;
+        z = e == 2 ? ti : z;
+        x = e == 3 ? pi : x;
+        y = e == 3 ? qi : y;
+        z = e == 3 ? vi : z;
+        x = e == 4 ? ti : x;
+        y = e == 4 ? pi : y;
+        z = e == 4 ? vi : z;
+        x = e == 5 ? vi : x;
+        y = e == 5 ? pi : y;
+        z = e == 5 ? qi : z;
+
+        r[i] = x;
+        g[i] = y;
+        b[i] = z;
+    }
+}
+
+typedef void (*Kernel) (const float* IMATH_RESTRICT,
+                        const float* IMATH_RESTRICT,
+                        const float* IMATH_RESTRICT,
+                        size_t,
+                        float* IMATH_RESTRICT,
+                        float* IMATH_RESTRICT,
+                        float* IMATH_RESTRICT);
+
+//
+// Apply a kernel to planar or interleaved channels of float or half,
+// in blocks of 64 colors, which are read before any of the results
+// are written, so that the colors can be converted in place.
+//
+
+template <class T>
+void
+convertPlanar (Kernel kernel,
+               const T* a,
+               const T* b,
+               const T* c,
+               size_t n,
+               T* x,
+               T* y,
+               T* z) noexcept
+{
+    float in0[64], in1[64], in2[64], out0[64], out1[64], out2[64];
+
+    for (size_t i0 = 0; i0 < n; i0 += 64)
+    {
+        size_t k = n - i0 < 64 ? n - i0 : 64;
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            in0[i] = float (a[i0 + i]);
+            in1[i] = float (b[i0 + i]);
+            in2[i] = float (c[i0 + i]);
+        }
+
+        kernel (in0, in1, in2, k, out0, out1, out2);
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            x[i0 + i] = T (out0[i]);
+            y[i0 + i] = T (out1[i]);
+            z[i0 + i] = T (out2[i]);
+        }
+    }
+}
+
+template <class C>
+void
+convertInterleaved (Kernel kernel, const C* in, size_t n, C* out) noexcept
+{
+    typedef typename C::BaseType T;
+
+    float in0[64], in1[64], in2[64], out0[64], out1[64], out2[64];
+
+    for (size_t i0 = 0; i0 < n; i0 += 64)
+    {
+        size_t k = n - i0 < 64 ? n - i0 : 64;
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            in0[i] = float (in[i0 + i][0]);
+            in1[i] = float (in[i0 + i][1]);
+            in2[i] = float (in[i0 + i][2]);
+        }
+
+        kernel (in0, in1, in2, k, out0, out1, out2);
+
+        //
+        // Copying the whole color carries alpha over.
+        //
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            C color     = in[i0 + i];
+            color[0]    = T (out0[i]);
+            color[1]    = T (out1[i]);
+            color[2]    = T (out2[i]);
+            out[i0 + i] = color;
+        }
+    }
+}
+
+} // namespace
+
+void
+rgb2hsv (const C3f* rgb, size_t n, C3f* hsv) noexcept
+{
+    convertInterleaved (rgb2hsvKernel, rgb, n, hsv);
+}
+
+void
+rgb2hsv (const C4f* rgb, size_t n, C4f* hsv) noexcept
+{
+    convertInterleaved (rgb2hsvKernel, rgb, n, hsv);
+}
+
+void
+rgb2hsv (const C3h* rgb, size_t n, C3h* hsv) noexcept
+{
+    convertInterleaved (rgb2hsvKernel, rgb, n, hsv);
+}
+
+void
+rgb2hsv (const C4h* rgb, size_t n, C4h* hsv) noexcept
+{
+    convertInterleaved (rgb2hsvKernel, rgb, n, hsv);
+}
+
+void
+rgb2hsv (const float* r,
+         const float* g,
+         const float* b,
+         size_t n,
+         float* h,
+         float* s,
+         float* v) noexcept
+{
+    convertPlanar (rgb2hsvKernel, r, g, b, n, h, s, v);
+}
+
+void
+rgb2hsv (const half* r, const half* g, const half* b, size_t n, half* h, half* s, half* v) noexcept
+{
+    convertPlanar (rgb2hsvKernel, r, g, b, n, h, s, v);
+}
+
+void
+hsv2rgb (const C3f* hsv, size_t n, C3f* rgb) noexcept
+{
+    convertInterleaved (hsv2rgbKernel, hsv, n, rgb);
+}
+
+void
+hsv2rgb (const C4f* hsv, size_t n, C4f* rgb) noexcept
+{
+    convertInterleaved (hsv2rgbKernel, hsv, n, rgb);
+}
+
+void
+hsv2rgb (const C3h* hsv, size_t n, C3h* rgb) noexcept
+{
+    convertInterleaved (hsv2rgbKernel, hsv, n, rgb);
+}
+
+void
+hsv2rgb (const C4h* hsv, size_t n, C4h* rgb) noexcept
+{
+    convertInterleaved (hsv2rgbKernel, hsv, n, rgb);
+}
+
+void
+hsv2rgb (const float* h,
+         const float* s,
+         const float* v,
+         size_t n,
+         float* r,
+         float* g,
+         float* b) noexcept
+{
+    convertPlanar (hsv2rgbKernel, h, s, v, n, r, g, b);
+}
+
+void
+hsv2rgb (const half* h, const half* s, const half* v, size_t n, half* r, half* g, half* b) noexcept
+{
+    convertPlanar (hsv2rgbKernel, h, s, v, n, r, g, b);
+}
+
 Vec3<double>
 hsv2rgb_d (const Vec3<double>& hsv) noexcept
 {
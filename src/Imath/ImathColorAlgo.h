@@ -16,6 +16,8 @@
 #include "ImathColor.h"
 #include "ImathMath.h"
 
+#include <cstddef>
+
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
 //
@@ -147,6 +149,80 @@ rgb2hsv (const Color4<T>& rgb) noexcept
     }
 }
 
+///
+/// Convert the `n` rgb colors `rgb[i]` to hsv, as `rgb2hsv()` does,
+/// and store them in `hsv[i]`. `hsv` may be the same array as `rgb`,
+/// to convert in place, but the arrays must not otherwise overlap.
+///
+/// The colors are converted in blocks, in float, without branches,
+/// in loops that compilers vectorize; the results differ from those
+/// of `rgb2hsv()`, which computes in double, by rounding.
+IMATH_EXPORT void rgb2hsv (const C3f* rgb, size_t n, C3f* hsv) noexcept;
+
+/// Convert `n` rgba colors to hsv, as above; alpha is copied.
+IMATH_EXPORT void rgb2hsv (const C4f* rgb, size_t n, C4f* hsv) noexcept;
+
+/// Convert `n` half rgb colors to hsv, as above, computing in float.
+IMATH_EXPORT void rgb2hsv (const C3h* rgb, size_t n, C3h* hsv) noexcept;
+
+/// Convert `n` half rgba colors to hsv, as above; alpha is copied.
+IMATH_EXPORT void rgb2hsv (const C4h* rgb, size_t n, C4h* hsv) noexcept;
+
+///
+/// Convert `n` rgb colors, stored in the separate channels `r`, `g`
+/// and `b`, to hsv, stored in `h`, `s` and `v`, as the conversion of
+/// arrays of colors above does. Each output channel may be the same
+/// array as the corresponding input channel, but the arrays must
+/// not otherwise overlap.
+IMATH_EXPORT void rgb2hsv (const float* r,
+                           const float* g,
+                           const float* b,
+                           size_t n,
+                           float* h,
+                           float* s,
+                           float* v) noexcept;
+
+/// Convert `n` half rgb colors in separate channels to hsv, as above.
+IMATH_EXPORT void
+rgb2hsv (const half* r, const half* g, const half* b, size_t n, half* h, half* s, half* v) noexcept;
+
+///
+/// Convert the `n` hsv colors `hsv[i]` to rgb, as `hsv2rgb()` does,
+/// and store them in `rgb[i]`. `rgb` may be the same array as `hsv`,
+/// to convert in place, but the arrays must not otherwise overlap.
+///
+/// The colors are converted in blocks, in float, without branches,
+/// in loops that compilers vectorize; the results differ from those
+/// of `hsv2rgb()`, which computes in double, by rounding.
+IMATH_EXPORT void hsv2rgb (const C3f* hsv, size_t n, C3f* rgb) noexcept;
+
+/// Convert `n` hsv colors with alpha to rgb, as above; alpha is copied.
+IMATH_EXPORT void hsv2rgb (const C4f* hsv, size_t n, C4f* rgb) noexcept;
+
+/// Convert `n` half hsv colors to rgb, as above, computing in float.
+IMATH_EXPORT void hsv2rgb (const C3h* hsv, size_t n, C3h* rgb) noexcept;
+
+/// Convert `n` half hsv colors with alpha to rgb, as above; alpha is copied.
+IMATH_EXPORT void hsv2rgb (const C4h* hsv, size_t n, C4h* rgb) noexcept;
+
+///
+/// Convert `n` hsv colors, stored in the separate channels `h`, `s`
+/// and `v`, to rgb, stored in `r`, `g` and `b`, as the conversion of
+/// arrays of colors above does. Each output channel may be the same
+/// array as the corresponding input channel, but the arrays must
+/// not otherwise overlap.
+IMATH_EXPORT void hsv2rgb (const float* h,
+                           const float* s,
+                           const float* v,
+                           size_t n,
+                           float* r,
+                           float* g,
+                           float* b) noexcept;
+
+/// Convert `n` half hsv colors in separate channels to rgb, as above.
+IMATH_EXPORT void
+hsv2rgb (const half* h, const half* s, const half* v, size_t n, half* r, half* g, half* b) noexcept;
+
 ///
 /// Convert 3-channel rgb to PackedColor
 ///
@@ -0,0 +1,447 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A dual quaternion, representing a rigid transformation
+//
+
+#ifndef INCLUDED_IMATHDUALQUAT_H
+#define INCLUDED_IMATHDUALQUAT_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathMatrixAlgo.h"
+#include "ImathQuat.h"
+
+#include <iostream>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The DualQuat class implements the dual quaternion numerical type.
+/// A unit dual quaternion represents a rigid transformation, that is
+/// a rotation followed by a translation, and unlike a matrix it can
+/// be blended linearly without introducing scaling or shear, which
+/// makes it the representation of choice for skinning.
+///
+/// The real part `r` is the rotation; the dual part is
+/// `d = 0.5 * (0, t) * r` for the translation `t`.
+///
+/// As with Quat, products compose right to left: `a * b` applies
+/// `b` first, then `a`, so that
+///
+///     (a * b).toMatrix44() == b.toMatrix44() * a.toMatrix44()
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE DualQuat
+{
+  public:
+
+    /// @{
+    /// @name Direct access to elements
+
+    /// The real part
+    Quat<T> r;
+
+    /// The dual part
+    Quat<T> d;
+
+    /// @}
+
+    /// @{
+    ///	@name Constructors
+
+    /// Default constructor is the identity transformation
+    IMATH_HOSTDEVICE constexpr DualQuat() noexcept;
+
+    /// Initialize with real part `r` and dual part `d`
+    IMATH_HOSTDEVICE constexpr DualQuat (const Quat<T>& r, const Quat<T>& d) noexcept;
+
+    /// Initialize with the rigid transformation that rotates by the
+    /// unit quaternion `rotation` and then translates by `translation`
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat (const Quat<T>& rotation,
+                                                 const Vec3<T>& translation) noexcept;
+
+    /// Initialize with the rigid part of the matrix `m`.  Scaling and
+    /// shear are removed before the rotation is extracted.
+    explicit DualQuat (const Matrix44<T>& m);
+
+    /// The identity transformation
+    IMATH_HOSTDEVICE constexpr static DualQuat<T> identity() noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Basic Algebra
+    ///
+    /// Note that the operator return values are *NOT* normalized
+
+    /// Dual quaternion multiplication
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator*= (const DualQuat<T>& q) noexcept;
+
+    /// Scalar multiplication
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator*= (T t) noexcept;
+
+    /// Dual quaternion addition
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 const DualQuat<T>& operator+= (const DualQuat<T>& q) noexcept;
+
+    /// Equality
+    template <class S>
+    IMATH_HOSTDEVICE constexpr bool operator== (const DualQuat<S>& q) const noexcept;
+
+    /// Inequality
+    template <class S>
+    IMATH_HOSTDEVICE constexpr bool operator!= (const DualQuat<S>& q) const noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Query
+
+    /// Return the rotation, assuming a unit dual quaternion
+    IMATH_HOSTDEVICE constexpr Quat<T> rotation() const noexcept;
+
+    /// Return the translation, assuming a unit dual quaternion
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T> translation() const noexcept;
+
+    /// Return the equivalent 4x4 matrix, assuming a unit dual quaternion
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Matrix44<T> toMatrix44() const noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Utility Methods
+
+    /// Normalize in place, so that the real part has unit length.
+    /// @return const reference to this.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T>& normalize() noexcept;
+
+    /// Return a normalized dual quaternion, leaving this unmodified.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 DualQuat<T> normalized() const noexcept;
+
+    /// Return the inverse transformation, assuming a unit dual quaternion
+    IMATH_HOSTDEVICE constexpr DualQuat<T> inverse() const noexcept;
+
+    /// Transform the point `p`: rotate, then translate.  Assumes a
+    /// unit dual quaternion.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T> transformPoint (const Vec3<T>& p) const noexcept;
+
+    /// Transform the direction `v`, which is only rotated.  Assumes a
+    /// unit dual quaternion.
+    IMATH_HOSTDEVICE IMATH_CONSTEXPR14 Vec3<T> transformDirection (const Vec3<T>& v) const noexcept;
+
+    /// @}
+
+    /// The base type: In templates that accept a parameter `V`, you
+    /// can refer to `T` as `V::BaseType`
+    typedef T BaseType;
+};
+
+/// Dual quaternion of type float
+typedef DualQuat<float> DualQuatf;
+
+/// Dual quaternion of type double
+typedef DualQuat<double> DualQuatd;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T> constexpr inline DualQuat<T>::DualQuat() noexcept : r(), d (0, 0, 0, 0)
+{
+    // empty
+}
+
+template <class T>
+constexpr inline DualQuat<T>::DualQuat (const Quat<T>& r, const Quat<T>& d) noexcept : r (r), d (d)
+{
+    // empty
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>::DualQuat (const Quat<T>& rotation,
+                                                const Vec3<T>& translation) noexcept
+    : r (rotation), d (Quat<T> (0, translation) * rotation * T (0.5))
+{
+    // empty
+}
+
+template <class T> inline DualQuat<T>::DualQuat (const Matrix44<T>& m)
+{
+    r = extractQuat (sansScalingAndShear (m, false)).normalized();
+    d = Quat<T> (0, m.translation()) * r * T (0.5);
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+DualQuat<T>::identity() noexcept
+{
+    return DualQuat<T>();
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (const DualQuat<T>& q) noexcept
+{
+    d = r * q.d + d * q.r;
+    r *= q.r;
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator*= (T t) noexcept
+{
+    r *= t;
+    d *= t;
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline const DualQuat<T>&
+DualQuat<T>::operator+= (const DualQuat<T>& q) noexcept
+{
+    r += q.r;
+    d += q.d;
+    return *this;
+}
+
+template <class T>
+template <class S>
+constexpr inline bool
+DualQuat<T>::operator== (const DualQuat<S>& q) const noexcept
+{
+    return r == q.r && d == q.d;
+}
+
+template <class T>
+template <class S>
+constexpr inline bool
+DualQuat<T>::operator!= (const DualQuat<S>& q) const noexcept
+{
+    return r != q.r || d != q.d;
+}
+
+template <class T>
+constexpr inline Quat<T>
+DualQuat<T>::rotation() const noexcept
+{
+    return r;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::translation() const noexcept
+{
+    //
+    // t = 2 * d * r*, whose real part vanishes for a unit
+    // dual quaternion.
+    //
+
+    return T (2) * (d.r * -r.v + r.r * d.v + d.v % -r.v);
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Matrix44<T>
+DualQuat<T>::toMatrix44() const noexcept
+{
+    Matrix44<T> m = r.toMatrix44();
+    Vec3<T> t     = translation();
+
+    m[3][0] = t.x;
+    m[3][1] = t.y;
+    m[3][2] = t.z;
+
+    return m;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>&
+DualQuat<T>::normalize() noexcept
+{
+    if (T l = r.length())
+    {
+        r /= l;
+        d /= l;
+    }
+    else
+    {
+        *this = DualQuat<T>();
+    }
+
+    return *this;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline DualQuat<T>
+DualQuat<T>::normalized() const noexcept
+{
+    if (T l = r.length())
+        return DualQuat (r / l, d / l);
+
+    return DualQuat();
+}
+
+template <class T>
+constexpr inline DualQuat<T>
+DualQuat<T>::inverse() const noexcept
+{
+    return DualQuat (~r, ~d);
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::transformDirection (const Vec3<T>& v) const noexcept
+{
+    return v * r;
+}
+
+template <class T>
+IMATH_CONSTEXPR14 inline Vec3<T>
+DualQuat<T>::transformPoint (const Vec3<T>& p) const noexcept
+{
+    return p * r + translation();
+}
+
+/// Stream output
+template <class T>
+std::ostream&
+operator<< (std::ostream& o, const DualQuat<T>& q)
+{
+    return o << "(" << q.r << " " << q.d << ")";
+}
+
+/// Dual quaternion multiplication
+/// @return q1 * q2, which applies q2 first, then q1
+template <class T>
+constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& q1, const DualQuat<T>& q2) noexcept
+{
+    return DualQuat<T> (q1.r * q2.r, q1.r * q2.d + q1.d * q2.r);
+}
+
+/// Dual quaternion*scalar multiplication
+template <class T>
+constexpr inline DualQuat<T>
+operator* (const DualQuat<T>& q, T t) noexcept
+{
+    return DualQuat<T> (q.r * t, q.d * t);
+}
+
+/// Scalar*dual quaternion multiplication
+template <class T>
+constexpr inline DualQuat<T>
+operator* (T t, const DualQuat<T>& q) noexcept
+{
+    return DualQuat<T> (q.r * t, q.d * t);
+}
+
+/// Dual quaternion addition
+template <class T>
+constexpr inline DualQuat<T>
+operator+ (const DualQuat<T>& q1, const DualQuat<T>& q2) noexcept
+{
+    return DualQuat<T> (q1.r + q2.r, q1.d + q2.d);
+}
+
+/// Negate the dual quaternion.  The result represents the same
+/// rigid transformation.
+template <class T>
+constexpr inline DualQuat<T>
+operator- (const DualQuat<T>& q) noexcept
+{
+    return DualQuat<T> (-q.r, -q.d);
+}
+
+///
+/// Dual quaternion linear blending, as described by Kavan et al. in
+/// "Geometric Skinning with Approximate Dual Quaternion Blending".
+///
+/// For each of the `n` points, `numInfluences` bone indices and
+/// weights are read from `boneIndices` and `weights`, starting at
+/// `i * numInfluences`.  The weighted bone transformations are summed
+/// in the hemisphere of the point's first influence and normalized,
+/// and the result is stored in `result[i]`.  A point whose weights
+/// sum to zero gets the identity.  `numInfluences` must be at least 1.
+template <class T>
+void
+blendDualQuats (const DualQuat<T>* bones,
+                const int* boneIndices,
+                const T* weights,
+                size_t numInfluences,
+                size_t n,
+                DualQuat<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int* index  = boneIndices + i * numInfluences;
+        const T* w        = weights + i * numInfluences;
+        const Quat<T>& r0 = bones[index[0]].r;
+
+        DualQuat<T> b (Quat<T> (0, 0, 0, 0), Quat<T> (0, 0, 0, 0));
+
+        for (size_t j = 0; j < numInfluences; ++j)
+        {
+            const DualQuat<T>& bone = bones[index[j]];
+            T wj                    = (r0 ^ bone.r) < 0 ? -w[j] : w[j];
+
+            b.r += wj * bone.r;
+            b.d += wj * bone.d;
+        }
+
+        result[i] = b.normalized();
+    }
+}
+
+///
+/// Dual quaternion skinning of points, and optionally normals.
+///
+/// Blends the bone transformations as blendDualQuats() does and
+/// applies the blend of point `i` to `points[i]`, storing the result
+/// in `result[i]`.  If `normals` and `normalsResult` are not null,
+/// `normals[i]` is rotated by the same blend into `normalsResult[i]`.
+///
+/// Replaces linear blend skinning, which averages bone matrices and
+/// so collapses volume where bones twist.
+template <class T>
+void
+skinDualQuat (const DualQuat<T>* bones,
+              const int* boneIndices,
+              const T* weights,
+              size_t numInfluences,
+              const Vec3<T>* points,
+              size_t n,
+              Vec3<T>* result,
+              const Vec3<T>* normals = nullptr,
+              Vec3<T>* normalsResult = nullptr) noexcept
+{
+    //
+    // Blend in small chunks, so the blended transformations stay
+    // in cache between the two passes.
+    //
+
+    const size_t chunk = 64;
+    DualQuat<T> blend[chunk];
+
+    for (size_t i = 0; i < n; i += chunk)
+    {
+        size_t m = n - i < chunk ? n - i : chunk;
+
+        blendDualQuats (bones, boneIndices + i * numInfluences, weights + i * numInfluences,
+                        numInfluences, m, blend);
+
+        for (size_t j = 0; j < m; ++j)
+            result[i + j] = blend[j].transformPoint (points[i + j]);
+
+        if (normals && normalsResult)
+            for (size_t j = 0; j < m; ++j)
+                normalsResult[i + j] = blend[j].transformDirection (normals[i + j]);
+    }
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHDUALQUAT_H
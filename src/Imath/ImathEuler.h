@@ -372,6 +372,150 @@ typedef Euler<float> Eulerf;
 /// Euler of type double
 typedef Euler<double> Eulerd;
 
+///
+/// Template struct `EulerOrder<Order>`
+///
+/// A compile-time description of one of the `Euler<T>::Order` values.
+/// Where the rotation order is known statically, the free functions
+/// `eulerToMatrix33()`, `eulerToMatrix44()`, `eulerToQuat()` and
+/// `eulerFromMatrix()` below use it to resolve the axis indices,
+/// parity and repetition at compile time, rather than decoding them
+/// from the `Euler` object for every conversion:
+///
+///     V3f angles (x_rot, y_rot, z_rot);
+///     M44f m = eulerToMatrix44<Eulerf::XYZ> (angles);
+///
+/// is equivalent to `Eulerf (angles, Eulerf::XYZ).toMatrix44()`.
+///
+/// As with `Euler<T>`, the angles are given in the "ijk" order of the
+/// enum, not in "xyz" order.
+///
+
+template <int Order> struct EulerOrder
+{
+    static_assert (Euler<float>::legal (Euler<float>::Order (Order)),
+                   "Illegal Euler order");
+
+    /// First axis of rotation
+    static constexpr int i = (Order >> 12) & 3;
+
+    /// "parity of axis permutation"
+    static constexpr bool parityEven = (Order & 0x100) != 0;
+
+    /// init axis repeated as last
+    static constexpr bool initialRepeated = (Order & 0x10) != 0;
+
+    /// relative or static rotations
+    static constexpr bool frameStatic = (Order & 0x1) != 0;
+
+    /// Second axis of rotation
+    static constexpr int j = parityEven ? (i + 1) % 3 : (i > 0 ? i - 1 : 2);
+
+    /// Third axis of rotation
+    static constexpr int k = parityEven ? (i > 0 ? i - 1 : 2) : (i + 1) % 3;
+};
+
+/// @{
+/// @name Euler Conversions with a Compile-time Order
+///
+/// The results are the same as those of the corresponding `Euler<T>`
+/// methods for an `Euler` with the given order. The array forms
+/// convert `n` elements.
+
+/// Convert the Euler angles `angles` (in ijk order) to a Matrix33.
+template <int Order, class T>
+IMATH_HOSTDEVICE Matrix33<T> eulerToMatrix33 (const Vec3<T>& angles) noexcept;
+
+/// Convert the Euler angles `angles` (in ijk order) to a Matrix44.
+template <int Order, class T>
+IMATH_HOSTDEVICE Matrix44<T> eulerToMatrix44 (const Vec3<T>& angles) noexcept;
+
+/// Convert the Euler angles `angles` (in ijk order) to a Quat.
+template <int Order, class T>
+IMATH_HOSTDEVICE Quat<T> eulerToQuat (const Vec3<T>& angles) noexcept;
+
+/// Extract the Euler angles (in ijk order) from the rotation matrix
+/// `M`. As with `Euler<T>::extract()`, the matrix is assumed not to
+/// include shear or non-uniform scaling.
+template <int Order, class T>
+IMATH_HOSTDEVICE Vec3<T> eulerFromMatrix (const Matrix33<T>& M) noexcept;
+
+/// Extract the Euler angles (in ijk order) from the rotation matrix
+/// `M`. As with `Euler<T>::extract()`, the matrix is assumed not to
+/// include shear or non-uniform scaling.
+template <int Order, class T>
+IMATH_HOSTDEVICE Vec3<T> eulerFromMatrix (const Matrix44<T>& M) noexcept;
+
+/// Convert the `n` Euler angle triples in `angles` to matrices.
+/// @param[in] angles Euler angles, in ijk order
+/// @param[in] n The number of elements
+/// @param[out] result The `n` rotation matrices
+template <int Order, class T>
+void eulerToMatrix44 (const Vec3<T>* angles, size_t n, Matrix44<T>* result) noexcept;
+
+/// Convert the `n` Euler angle triples in `angles` to quaternions.
+/// @param[in] angles Euler angles, in ijk order
+/// @param[in] n The number of elements
+/// @param[out] result The `n` quaternions
+template <int Order, class T>
+void eulerToQuat (const Vec3<T>* angles, size_t n, Quat<T>* result) noexcept;
+
+/// Extract the Euler angles from each of the `n` matrices in `M`.
+/// @param[in] M Rotation matrices
+/// @param[in] n The number of elements
+/// @param[out] result The `n` Euler angle triples, in ijk order
+template <int Order, class T>
+void eulerFromMatrix (const Matrix44<T>* M, size_t n, Vec3<T>* result) noexcept;
+
+/// @}
+
+/// @{
+/// @name Unwrapping Euler Angle Curves
+///
+/// These functions adjust a sequence of Euler angle samples so that
+/// each sample differs as little as possible from the one before it,
+/// removing the jumps of 2*PI (and the equivalent flips of the
+/// middle angle) that appear when angles are extracted from matrices
+/// one sample at a time. The first sample of each curve is left
+/// unchanged. As with `Euler<T>::makeNear()`, this is intended for
+/// the non-repeated orders.
+
+/// Unwrap the curve of `n` samples, in place, by calling
+/// `samples[i].makeNear (samples[i-1])` for each sample in turn.
+template <class T> void unwrapEulerCurve (Euler<T>* samples, size_t n) noexcept;
+
+/// Unwrap `numCurves` curves of `numSamples` samples each, in place.
+///
+/// The angles are given in structure-of-arrays form and in xyz
+/// layout (see `Euler<T>::toXYZVector()`): sample `s` of curve `c` is
+/// `(x[s*stride+c], y[s*stride+c], z[s*stride+c])`. Each curve is
+/// processed serially, but the curves are independent and are
+/// processed together, one sample at a time, so that the work
+/// vectorizes across curves. A range of curves `[c0, c1)` may be
+/// unwrapped separately by passing `x + c0`, `y + c0`, `z + c0` and
+/// `numCurves = c1 - c0`, with the same `stride`.
+///
+/// The result is the same as that of `Euler<T>::nearestRotation()`,
+/// up to rounding.
+///
+/// @param[in] order The rotation order of all the curves
+/// @param[in,out] x The x angles
+/// @param[in,out] y The y angles
+/// @param[in,out] z The z angles
+/// @param[in] numCurves The number of curves
+/// @param[in] numSamples The number of samples in each curve
+/// @param[in] stride The distance between consecutive samples of a curve
+template <class T>
+void unwrapEulerCurves (typename Euler<T>::Order order,
+                        T* x,
+                        T* y,
+                        T* z,
+                        size_t numCurves,
+                        size_t numSamples,
+                        size_t stride) noexcept;
+
+/// @}
+
 //
 // Implementation
 //
@@ -1024,6 +1168,317 @@ Euler<T>::makeNear (const Euler<T>& target) noexcept
     setXYZVector (xyzRot);
 }
 
+template <int Order, class T, class M>
+IMATH_HOSTDEVICE inline void
+eulerSetRotation (const Vec3<T>& e, M& m) noexcept
+{
+    typedef EulerOrder<Order> O;
+
+    const int i = O::i;
+    const int j = O::j;
+    const int k = O::k;
+
+    Vec3<T> angles = O::frameStatic ? e : Vec3<T> (e.z, e.y, e.x);
+
+    if (!O::parityEven)
+        angles *= -1.0;
+
+    T ci = std::cos (angles.x);
+    T cj = std::cos (angles.y);
+    T ch = std::cos (angles.z);
+    T si = std::sin (angles.x);
+    T sj = std::sin (angles.y);
+    T sh = std::sin (angles.z);
+
+    T cc = ci * ch;
+    T cs = ci * sh;
+    T sc = si * ch;
+    T ss = si * sh;
+
+    if (O::initialRepeated)
+    {
+        m[i][i] = cj;
+        m[j][i] = sj * si;
+        m[k][i] = sj * ci;
+        m[i][j] = sj * sh;
+        m[j][j] = -cj * ss + cc;
+        m[k][j] = -cj * cs - sc;
+        m[i][k] = -sj * ch;
+        m[j][k] = cj * sc + cs;
+        m[k][k] = cj * cc - ss;
+    }
+    else
+    {
+        m[i][i] = cj * ch;
+        m[j][i] = sj * sc - cs;
+        m[k][i] = sj * cc + ss;
+        m[i][j] = cj * sh;
+        m[j][j] = sj * ss + cc;
+        m[k][j] = sj * cs - sc;
+        m[i][k] = -sj;
+        m[j][k] = cj * si;
+        m[k][k] = cj * ci;
+    }
+}
+
+template <int Order, class T>
+IMATH_HOSTDEVICE inline Matrix33<T>
+eulerToMatrix33 (const Vec3<T>& angles) noexcept
+{
+    Matrix33<T> M;
+    eulerSetRotation<Order> (angles, M);
+    return M;
+}
+
+template <int Order, class T>
+IMATH_HOSTDEVICE inline Matrix44<T>
+eulerToMatrix44 (const Vec3<T>& angles) noexcept
+{
+    Matrix44<T> M;
+    eulerSetRotation<Order> (angles, M);
+    return M;
+}
+
+template <int Order, class T>
+IMATH_HOSTDEVICE inline Quat<T>
+eulerToQuat (const Vec3<T>& e) noexcept
+{
+    typedef EulerOrder<Order> O;
+
+    Vec3<T> angles = O::frameStatic ? e : Vec3<T> (e.z, e.y, e.x);
+
+    if (!O::parityEven)
+        angles.y = -angles.y;
+
+    T ti = angles.x * 0.5;
+    T tj = angles.y * 0.5;
+    T th = angles.z * 0.5;
+    T ci = std::cos (ti);
+    T cj = std::cos (tj);
+    T ch = std::cos (th);
+    T si = std::sin (ti);
+    T sj = std::sin (tj);
+    T sh = std::sin (th);
+    T cc = ci * ch;
+    T cs = ci * sh;
+    T sc = si * ch;
+    T ss = si * sh;
+
+    const T parity = O::parityEven ? 1.0 : -1.0;
+
+    Quat<T> q;
+
+    if (O::initialRepeated)
+    {
+        q.v[O::i] = cj * (cs + sc);
+        q.v[O::j] = sj * (cc + ss) * parity;
+        q.v[O::k] = sj * (cs - sc);
+        q.r       = cj * (cc - ss);
+    }
+    else
+    {
+        q.v[O::i] = cj * sc - sj * cs;
+        q.v[O::j] = (cj * ss + sj * cc) * parity;
+        q.v[O::k] = cj * cs - sj * sc;
+        q.r       = cj * cc + sj * ss;
+    }
+
+    return q;
+}
+
+template <int Order, class T>
+IMATH_HOSTDEVICE inline Vec3<T>
+eulerFromMatrix (const Matrix33<T>& M) noexcept
+{
+    return eulerFromMatrix<Order> (Matrix44<T> (M[0][0],
+                                                M[0][1],
+                                                M[0][2],
+                                                0,
+                                                M[1][0],
+                                                M[1][1],
+                                                M[1][2],
+                                                0,
+                                                M[2][0],
+                                                M[2][1],
+                                                M[2][2],
+                                                0,
+                                                0,
+                                                0,
+                                                0,
+                                                1));
+}
+
+template <int Order, class T>
+IMATH_HOSTDEVICE inline Vec3<T>
+eulerFromMatrix (const Matrix44<T>& M) noexcept
+{
+    typedef EulerOrder<Order> O;
+
+    const int i = O::i;
+    const int j = O::j;
+    const int k = O::k;
+
+    Vec3<T> e;
+
+    //
+    // Extract the first angle, x, remove its rotation from M, and
+    // extract the other two angles from the remaining rotation, N.
+    // See Euler<T>::extract().
+    //
+
+    e.x = O::initialRepeated ? std::atan2 (M[j][i], M[k][i]) : std::atan2 (M[j][k], M[k][k]);
+
+    Vec3<T> r (0, 0, 0);
+    r[i] = (O::parityEven ? -e.x : e.x);
+
+    Matrix44<T> N;
+    N.rotate (r);
+    N = N * M;
+
+    if (O::initialRepeated)
+    {
+        T sy = std::sqrt (N[j][i] * N[j][i] + N[k][i] * N[k][i]);
+        e.y  = std::atan2 (sy, N[i][i]);
+        e.z  = std::atan2 (N[j][k], N[j][j]);
+    }
+    else
+    {
+        T cy = std::sqrt (N[i][i] * N[i][i] + N[i][j] * N[i][j]);
+        e.y  = std::atan2 (-N[i][k], cy);
+        e.z  = std::atan2 (-N[j][i], N[j][j]);
+    }
+
+    if (!O::parityEven)
+        e *= -1;
+
+    if (!O::frameStatic)
+    {
+        T t = e.x;
+        e.x = e.z;
+        e.z = t;
+    }
+
+    return e;
+}
+
+template <int Order, class T>
+void
+eulerToMatrix44 (const Vec3<T>* angles, size_t n, Matrix44<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        result[i].makeIdentity();
+        eulerSetRotation<Order> (angles[i], result[i]);
+    }
+}
+
+template <int Order, class T>
+void
+eulerToQuat (const Vec3<T>* angles, size_t n, Quat<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = eulerToQuat<Order> (angles[i]);
+}
+
+template <int Order, class T>
+void
+eulerFromMatrix (const Matrix44<T>* M, size_t n, Vec3<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = eulerFromMatrix<Order> (M[i]);
+}
+
+template <class T>
+void
+unwrapEulerCurve (Euler<T>* samples, size_t n) noexcept
+{
+    for (size_t i = 1; i < n; ++i)
+        samples[i].makeNear (samples[i - 1]);
+}
+
+//
+// Make one sample of each of n curves near the previous sample,
+// (px, py, pz). The branch-free form of nearestRotation(): both
+// candidates are computed, with the equivalent of angleMod()
+// written without fmod(), and the nearer one is selected. (sx, sy,
+// sz) is -1 for the middle axis of the rotation order and +1 for
+// the others.
+//
+
+template <class T>
+inline void
+unwrapEulerSample (const T* IMATH_RESTRICT px,
+                   const T* IMATH_RESTRICT py,
+                   const T* IMATH_RESTRICT pz,
+                   T* IMATH_RESTRICT x,
+                   T* IMATH_RESTRICT y,
+                   T* IMATH_RESTRICT z,
+                   size_t n,
+                   T sx,
+                   T sy,
+                   T sz) noexcept
+{
+    const T pi       = T (M_PI);
+    const T twoPi    = T (2 * M_PI);
+    const T invTwoPi = T (1 / (2 * M_PI));
+
+    for (size_t c = 0; c < n; ++c)
+    {
+        T tx = px[c];
+        T ty = py[c];
+        T tz = pz[c];
+
+        T dx = x[c] - tx;
+        T dy = y[c] - ty;
+        T dz = z[c] - tz;
+
+        dx -= twoPi * std::floor (dx * invTwoPi + T (0.5));
+        dy -= twoPi * std::floor (dy * invTwoPi + T (0.5));
+        dz -= twoPi * std::floor (dz * invTwoPi + T (0.5));
+
+        T ox = pi + sx * (tx + dx) - tx;
+        T oy = pi + sy * (ty + dy) - ty;
+        T oz = pi + sz * (tz + dz) - tz;
+
+        ox -= twoPi * std::floor (ox * invTwoPi + T (0.5));
+        oy -= twoPi * std::floor (oy * invTwoPi + T (0.5));
+        oz -= twoPi * std::floor (oz * invTwoPi + T (0.5));
+
+        bool other = ox * ox + oy * oy + oz * oz < dx * dx + dy * dy + dz * dz;
+
+        x[c] = tx + (other ? ox : dx);
+        y[c] = ty + (other ? oy : dy);
+        z[c] = tz + (other ? oz : dz);
+    }
+}
+
+template <class T>
+void
+unwrapEulerCurves (typename Euler<T>::Order order,
+                   T* x,
+                   T* y,
+                   T* z,
+                   size_t numCurves,
+                   size_t numSamples,
+                   size_t stride) noexcept
+{
+    int i, j, k;
+    Euler<T> e (order);
+    e.angleOrder (i, j, k);
+
+    const T sx = j == 0 ? -1 : 1;
+    const T sy = j == 1 ? -1 : 1;
+    const T sz = j == 2 ? -1 : 1;
+
+    for (size_t s = 1; s < numSamples; ++s)
+    {
+        size_t p = (s - 1) * stride;
+        size_t q = s * stride;
+
+        unwrapEulerSample (x + p, y + p, z + p, x + q, y + q, z + q, numCurves, sx, sy, sz);
+    }
+}
+
 #if (defined _WIN32 || defined _WIN64) && defined _MSC_VER
 #    pragma warning(default : 4244)
 #endif
@@ -27,10 +27,16 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 #ifndef INCLUDED_IMATHBOX_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Box;
 #endif
+#ifndef INCLUDED_IMATHBVH_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE BVH;
+#endif
 #ifndef INCLUDED_IMATHCOLOR_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Color3;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Color4;
 #endif
+#ifndef INCLUDED_IMATHDUALQUAT_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE DualQuat;
+#endif
 #ifndef INCLUDED_IMATHEULER_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Euler;
 #endif
@@ -56,6 +62,9 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Plane3;
 #ifndef INCLUDED_IMATHQUAT_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Quat;
 #endif
+#ifndef INCLUDED_IMATHQUATSPLINE_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE QuatSpline;
+#endif
 #ifndef INCLUDED_IMATHSHEAR_H
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Shear6;
 #endif
@@ -67,6 +76,9 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec2;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3;
 template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec4;
 #endif
+#ifndef INCLUDED_IMATHVECARRAY_H
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3Array;
+#endif
 
 #ifndef INCLUDED_IMATHRANDOM_H
 class IMATH_EXPORT_TYPE Rand32;
@@ -12,6 +12,7 @@
 
 #include "ImathExport.h"
 #include "ImathNamespace.h"
+#include "ImathPlatform.h"
 
 #include "ImathFun.h"
 #include "ImathLine.h"
@@ -188,6 +189,39 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Frustum
     /// exception if the point cannot be projected.
     IMATH_CONSTEXPR14 Vec2<T> projectPointToScreenExc (const Vec3<T>&) const;
 
+    /// Project the `n` points `(x[i], y[i], z[i])` into screen
+    /// coordinates `(screenX[i], screenY[i])`, as
+    /// `projectPointToScreen()` does, to within rounding. If
+    /// `normalizedZ` is not null, it is set to the normalized z value
+    /// of the point's depth, the inverse of `normalizedZToDepth()`:
+    /// 0 on the near plane and 1 on the far plane. A perspective
+    /// projection of a point at depth 0 has infinite normalized z.
+    ///
+    /// The constants of the projection are computed once for all the
+    /// points.
+    void projectPointToScreen (const T* IMATH_RESTRICT x,
+                               const T* IMATH_RESTRICT y,
+                               const T* IMATH_RESTRICT z,
+                               size_t n,
+                               T* IMATH_RESTRICT screenX,
+                               T* IMATH_RESTRICT screenY,
+                               T* IMATH_RESTRICT normalizedZ = nullptr) const noexcept;
+
+    /// Project the `n` screen points `(screenX[i], screenY[i])` to
+    /// rays, setting `(posX[i], posY[i], posZ[i])` and
+    /// `(dirX[i], dirY[i], dirZ[i])` to the position and unit
+    /// direction of the ray that `projectScreenToRay()` returns, to
+    /// within rounding.
+    void projectScreenToRay (const T* IMATH_RESTRICT screenX,
+                             const T* IMATH_RESTRICT screenY,
+                             size_t n,
+                             T* IMATH_RESTRICT posX,
+                             T* IMATH_RESTRICT posY,
+                             T* IMATH_RESTRICT posZ,
+                             T* IMATH_RESTRICT dirX,
+                             T* IMATH_RESTRICT dirY,
+                             T* IMATH_RESTRICT dirZ) const noexcept;
+
     /// Map a z value to its depth in the frustum.
     IMATH_HOSTDEVICE IMATH_CONSTEXPR14 T ZToDepth (long zval,
                                                    long min,
@@ -662,6 +696,131 @@ Frustum<T>::projectPointToScreen (const Vec3<T>& point) const noexcept
             Vec2<T> (point.x * _nearPlane / -point.z, point.y * _nearPlane / -point.z));
 }
 
+template <class T>
+void
+Frustum<T>::projectPointToScreen (const T* IMATH_RESTRICT x,
+                                  const T* IMATH_RESTRICT y,
+                                  const T* IMATH_RESTRICT z,
+                                  size_t n,
+                                  T* IMATH_RESTRICT screenX,
+                                  T* IMATH_RESTRICT screenY,
+                                  T* IMATH_RESTRICT normalizedZ) const noexcept
+{
+    //
+    // localToScreen() is affine: screen = offset + scale * local.
+    //
+
+    T scaleX  = T (2) / (_right - _left);
+    T scaleY  = T (2) / (_top - _bottom);
+    T offsetX = (_left + _right) / (_left - _right);
+    T offsetY = (_bottom + _top) / (_bottom - _top);
+
+    if (_orthographic)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            screenX[i] = offsetX + scaleX * x[i];
+            screenY[i] = offsetY + scaleY * y[i];
+        }
+    }
+    else
+    {
+        //
+        // A point at depth 0 is not divided by its depth; selecting
+        // the divisor rather than the quotient keeps the loop free of
+        // branches.
+        //
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T w        = z[i] == T (0) ? -_nearPlane : z[i];
+            T s        = _nearPlane / -w;
+            screenX[i] = offsetX + scaleX * (x[i] * s);
+            screenY[i] = offsetY + scaleY * (y[i] * s);
+        }
+    }
+
+    if (normalizedZ == nullptr)
+        return;
+
+    //
+    // The normalized z is affine in the depth for an orthographic
+    // projection, and in its reciprocal for a perspective one.
+    //
+
+    T farMinusNear = _farPlane - _nearPlane;
+
+    if (_orthographic)
+    {
+        T scale  = T (-1) / farMinusNear;
+        T offset = -_nearPlane / farMinusNear;
+
+        for (size_t i = 0; i < n; ++i)
+            normalizedZ[i] = offset + scale * z[i];
+    }
+    else
+    {
+        T scale  = _farPlane * _nearPlane / farMinusNear;
+        T offset = _farPlane / farMinusNear;
+
+        for (size_t i = 0; i < n; ++i)
+            normalizedZ[i] = offset + scale / z[i];
+    }
+}
+
+template <class T>
+void
+Frustum<T>::projectScreenToRay (const T* IMATH_RESTRICT screenX,
+                                const T* IMATH_RESTRICT screenY,
+                                size_t n,
+                                T* IMATH_RESTRICT posX,
+                                T* IMATH_RESTRICT posY,
+                                T* IMATH_RESTRICT posZ,
+                                T* IMATH_RESTRICT dirX,
+                                T* IMATH_RESTRICT dirY,
+                                T* IMATH_RESTRICT dirZ) const noexcept
+{
+    //
+    // screenToLocal() is affine: local = offset + scale * screen.
+    //
+
+    T scaleX  = (_right - _left) / T (2);
+    T scaleY  = (_top - _bottom) / T (2);
+    T offsetX = (_left + _right) / T (2);
+    T offsetY = (_bottom + _top) / T (2);
+
+    if (_orthographic)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            posX[i] = offsetX + scaleX * screenX[i];
+            posY[i] = offsetY + scaleY * screenY[i];
+            posZ[i] = 0;
+            dirX[i] = 0;
+            dirY[i] = 0;
+            dirZ[i] = -1;
+        }
+    }
+    else
+    {
+        T nearSquared = _nearPlane * _nearPlane;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T lx = offsetX + scaleX * screenX[i];
+            T ly = offsetY + scaleY * screenY[i];
+            T r  = T (1) / std::sqrt (lx * lx + ly * ly + nearSquared);
+
+            posX[i] = 0;
+            posY[i] = 0;
+            posZ[i] = 0;
+            dirX[i] = lx * r;
+            dirY[i] = ly * r;
+            dirZ[i] = -_nearPlane * r;
+        }
+    }
+}
+
 template <class T>
 IMATH_CONSTEXPR14 T
 Frustum<T>::ZToDepthExc (long zval, long zmin, long zmax) const
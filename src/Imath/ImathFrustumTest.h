@@ -17,6 +17,7 @@
 
 #include "ImathExport.h"
 #include "ImathNamespace.h"
+#include "ImathPlatform.h"
 
 #include "ImathBox.h"
 #include "ImathFrustum.h"
@@ -24,6 +25,9 @@
 #include "ImathSphere.h"
 #include "ImathVec.h"
 
+#include <cstddef>
+#include <cstdint>
+
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
 ///
@@ -55,6 +59,21 @@ IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 ///    myFrustumTest.completelyContains(myBox)
 ///    myFrustumTest.completelyContains(mySphere)
 ///
+/// To cull a hierarchy of boxes, start each path from the root with
+/// all six planes active, and pass the planes that a box straddles on
+/// to its children:
+///    unsigned int planeMask = 0x3f; int lastPlane = 0;
+///    myFrustumTest.isVisible(myBox, planeMask, lastPlane)
+///
+/// To cull many boxes at once, store their corners as separate
+/// arrays of coordinates and call:
+///    myFrustumTest.isVisible(minX, minY, minZ, maxX, maxY, maxZ, n, bits)
+///
+/// and likewise for spheres, given as arrays of their centers' coordinates
+/// and their radii:
+///    myFrustumTest.classify(centerX, centerY, centerZ, radius, n,
+///                           visibleBits, containedBits)
+///
 /// Explanation of how it works
 ///
 /// We store six world-space Frustum planes (nx, ny, nz, offset)
@@ -137,6 +156,108 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE FrustumTest
     /// The result MAY return close false-negatives, but not false-positives.
     bool completelyContains (const Box<Vec3<T>>& box) const noexcept;
 
+    /// Return true if any part of the box is inside the frustum,
+    /// testing only the planes whose bits are set in `planeMask`.
+    /// Bit `i` stands for plane `i` in the order of
+    /// `Frustum::planes()`: top, right, bottom, left, near, far. The
+    /// other planes are assumed to contain the box, as they do when
+    /// they contain an enclosing box.
+    ///
+    /// The bits of the planes found to contain the box are cleared
+    /// from `planeMask`, so if the box is visible, `planeMask` holds
+    /// the planes that the box straddles, which are the only ones
+    /// its children need to be tested against. If it is 0, the box
+    /// is completely inside the frustum.
+    ///
+    /// Plane `lastPlane` is tested first. If the box is culled,
+    /// `lastPlane` is set to the plane that culled it, since that
+    /// plane is likely to cull the next box as well.
+    ///
+    /// With `planeMask` 0x3f, the result is that of `isVisible(box)`.
+    bool isVisible (const Box<Vec3<T>>& box,
+                    unsigned int& planeMask,
+                    int& lastPlane) const noexcept;
+
+    /// Return true if every part of the box is inside the active
+    /// planes, whose bits are set in `planeMask`, as for the masked
+    /// `isVisible()`. The bits of the planes found to contain the
+    /// box are cleared from `planeMask`. If the box is not contained,
+    /// `lastPlane` is set to the first plane found not to contain it.
+    ///
+    /// With `planeMask` 0x3f, the result is that of
+    /// `completelyContains(box)`.
+    bool completelyContains (const Box<Vec3<T>>& box,
+                             unsigned int& planeMask,
+                             int& lastPlane) const noexcept;
+
+    /// Test `n` boxes, given as arrays of their corner coordinates,
+    /// for visibility. Bit `i % 64` of `visible[i / 64]` is set if
+    /// box `i` is visible, with the same result as
+    /// `isVisible(Box<Vec3<T>>)`; the unused bits of the last word
+    /// are cleared. `visible` must hold `(n + 63) / 64` words.
+    /// Return the number of visible boxes.
+    size_t isVisible (const T* IMATH_RESTRICT minX,
+                      const T* IMATH_RESTRICT minY,
+                      const T* IMATH_RESTRICT minZ,
+                      const T* IMATH_RESTRICT maxX,
+                      const T* IMATH_RESTRICT maxY,
+                      const T* IMATH_RESTRICT maxZ,
+                      size_t n,
+                      uint64_t* IMATH_RESTRICT visible) const noexcept;
+
+    /// Test `n` boxes, given as arrays of their corner coordinates,
+    /// for containment, setting the bits of `contained` as for the
+    /// batched `isVisible()`, with the same result as
+    /// `completelyContains(Box<Vec3<T>>)`. Return the number of
+    /// contained boxes.
+    size_t completelyContains (const T* IMATH_RESTRICT minX,
+                               const T* IMATH_RESTRICT minY,
+                               const T* IMATH_RESTRICT minZ,
+                               const T* IMATH_RESTRICT maxX,
+                               const T* IMATH_RESTRICT maxY,
+                               const T* IMATH_RESTRICT maxZ,
+                               size_t n,
+                               uint64_t* IMATH_RESTRICT contained) const noexcept;
+
+    /// Test `n` spheres, given as arrays of their centers' coordinates
+    /// and their radii, for visibility. Bit `i % 64` of
+    /// `visible[i / 64]` is set if sphere `i` is visible, with the
+    /// same result as `isVisible(Sphere3<T>)`; the unused bits of
+    /// the last word are cleared. `visible` must hold `(n + 63) / 64`
+    /// words. Return the number of visible spheres.
+    size_t isVisible (const T* IMATH_RESTRICT centerX,
+                      const T* IMATH_RESTRICT centerY,
+                      const T* IMATH_RESTRICT centerZ,
+                      const T* IMATH_RESTRICT radius,
+                      size_t n,
+                      uint64_t* IMATH_RESTRICT visible) const noexcept;
+
+    /// Test `n` spheres for containment, setting the bits of
+    /// `contained` as for the batched `isVisible()`, with the same
+    /// result as `completelyContains(Sphere3<T>)`. Return the number
+    /// of contained spheres.
+    size_t completelyContains (const T* IMATH_RESTRICT centerX,
+                               const T* IMATH_RESTRICT centerY,
+                               const T* IMATH_RESTRICT centerZ,
+                               const T* IMATH_RESTRICT radius,
+                               size_t n,
+                               uint64_t* IMATH_RESTRICT contained) const noexcept;
+
+    /// Classify `n` spheres as outside, intersecting or inside the
+    /// frustum in a single pass, setting the bits of `visible` and
+    /// `contained` as the batched `isVisible()` and
+    /// `completelyContains()` do. A sphere is outside if its visible
+    /// bit is clear, inside if its contained bit is set, and
+    /// intersects the frustum otherwise. Return the number of visible
+    /// spheres.
+    size_t classify (const T* IMATH_RESTRICT centerX,
+                     const T* IMATH_RESTRICT centerY,
+                     const T* IMATH_RESTRICT centerZ,
+                     const T* IMATH_RESTRICT radius,
+                     size_t n,
+                     uint64_t* IMATH_RESTRICT visible,
+                     uint64_t* IMATH_RESTRICT contained) const noexcept;
+
     /// Return the camera matrix (primarily for debugging)
     IMATH_INTERNAL_NAMESPACE::Matrix44<T> cameraMat() const noexcept { return cameraMatrix; }
 
@@ -167,6 +288,41 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE FrustumTest
     Frustum<T> currFrustum;
     Matrix44<T> cameraMatrix;
 
+    // Return the signed distances to plane p of the nearest and
+    // farthest points of a box, computed as in the tests of single
+    // boxes.
+    void planeDistances (int p,
+                         const Vec3<T>& center,
+                         const Vec3<T>& extent,
+                         T& nearDist,
+                         T& farDist) const noexcept;
+
+    // The batched box tests: with Contains false, bit i is set if
+    // box i is visible, otherwise if it is completely contained.
+    template <bool Contains>
+    size_t testBoxes (const T* IMATH_RESTRICT minX,
+                      const T* IMATH_RESTRICT minY,
+                      const T* IMATH_RESTRICT minZ,
+                      const T* IMATH_RESTRICT maxX,
+                      const T* IMATH_RESTRICT maxY,
+                      const T* IMATH_RESTRICT maxZ,
+                      size_t n,
+                      uint64_t* IMATH_RESTRICT bits) const noexcept;
+
+    // The batched sphere tests, setting the bits of visible and
+    // contained spheres if Visible and Contained are true, and adding
+    // their counts to numVisible and numContained.
+    template <bool Visible, bool Contained>
+    void testSpheres (const T* IMATH_RESTRICT centerX,
+                      const T* IMATH_RESTRICT centerY,
+                      const T* IMATH_RESTRICT centerZ,
+                      const T* IMATH_RESTRICT radius,
+                      size_t n,
+                      uint64_t* IMATH_RESTRICT visible,
+                      uint64_t* IMATH_RESTRICT contained,
+                      size_t& numVisible,
+                      size_t& numContained) const noexcept;
+
     /// @endcond
 };
 
@@ -333,6 +489,349 @@ FrustumTest<T>::isVisible (const Vec3<T>& vec) const noexcept
     return true;
 }
 
+template <typename T>
+inline void
+FrustumTest<T>::planeDistances (int p,
+                                const Vec3<T>& center,
+                                const Vec3<T>& extent,
+                                T& nearDist,
+                                T& farDist) const noexcept
+{
+    int i = p / 3;
+    int j = p % 3;
+
+    T d = planeNormX[i][j] * center.x + planeNormY[i][j] * center.y + planeNormZ[i][j] * center.z;
+
+    nearDist = d - planeNormAbsX[i][j] * extent.x - planeNormAbsY[i][j] * extent.y -
+               planeNormAbsZ[i][j] * extent.z - planeOffsetVec[i][j];
+    farDist = d + planeNormAbsX[i][j] * extent.x + planeNormAbsY[i][j] * extent.y +
+              planeNormAbsZ[i][j] * extent.z - planeOffsetVec[i][j];
+}
+
+template <typename T>
+bool
+FrustumTest<T>::isVisible (const Box<Vec3<T>>& box,
+                           unsigned int& planeMask,
+                           int& lastPlane) const noexcept
+{
+    if (box.isEmpty())
+        return false;
+
+    Vec3<T> center = (box.min + box.max) / 2;
+    Vec3<T> extent = (box.max - center);
+
+    int first = lastPlane >= 0 && lastPlane < 6 ? lastPlane : 0;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        int p = first + i < 6 ? first + i : first + i - 6;
+        unsigned int bit = 1u << p;
+
+        if (!(planeMask & bit))
+            continue;
+
+        T nearDist, farDist;
+        planeDistances (p, center, extent, nearDist, farDist);
+
+        if (nearDist >= 0)
+        {
+            lastPlane = p;
+            return false;
+        }
+
+        if (farDist < 0)
+            planeMask &= ~bit;
+    }
+
+    return true;
+}
+
+template <typename T>
+bool
+FrustumTest<T>::completelyContains (const Box<Vec3<T>>& box,
+                                    unsigned int& planeMask,
+                                    int& lastPlane) const noexcept
+{
+    if (box.isEmpty())
+        return false;
+
+    Vec3<T> center = (box.min + box.max) / 2;
+    Vec3<T> extent = (box.max - center);
+
+    int first = lastPlane >= 0 && lastPlane < 6 ? lastPlane : 0;
+
+    for (int i = 0; i < 6; ++i)
+    {
+        int p = first + i < 6 ? first + i : first + i - 6;
+        unsigned int bit = 1u << p;
+
+        if (!(planeMask & bit))
+            continue;
+
+        T nearDist, farDist;
+        planeDistances (p, center, extent, nearDist, farDist);
+
+        if (farDist >= 0)
+        {
+            lastPlane = p;
+            return false;
+        }
+
+        planeMask &= ~bit;
+    }
+
+    return true;
+}
+
+template <typename T>
+template <bool Contains>
+size_t
+FrustumTest<T>::testBoxes (const T* IMATH_RESTRICT minX,
+                           const T* IMATH_RESTRICT minY,
+                           const T* IMATH_RESTRICT minZ,
+                           const T* IMATH_RESTRICT maxX,
+                           const T* IMATH_RESTRICT maxY,
+                           const T* IMATH_RESTRICT maxZ,
+                           size_t n,
+                           uint64_t* IMATH_RESTRICT bits) const noexcept
+{
+    //
+    // Copy the transposed planes into locals, so that they stay in
+    // registers, and test a block of boxes against all six planes
+    // without branches, so that the loop vectorizes. The arithmetic
+    // is the same as in the single-box tests, so the results agree
+    // exactly. The flags of a block are then packed into a word.
+    //
+
+    T nx[6], ny[6], nz[6], ax[6], ay[6], az[6], o[6];
+
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            nx[i * 3 + j] = planeNormX[i][j];
+            ny[i * 3 + j] = planeNormY[i][j];
+            nz[i * 3 + j] = planeNormZ[i][j];
+            ax[i * 3 + j] = planeNormAbsX[i][j];
+            ay[i * 3 + j] = planeNormAbsY[i][j];
+            az[i * 3 + j] = planeNormAbsZ[i][j];
+            o[i * 3 + j]  = planeOffsetVec[i][j];
+        }
+    }
+
+    const size_t blockSize = 64;
+    size_t count           = 0;
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        int outside[blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t k = b + i;
+
+            T cx = (minX[k] + maxX[k]) / 2;
+            T cy = (minY[k] + maxY[k]) / 2;
+            T cz = (minZ[k] + maxZ[k]) / 2;
+            T ex = maxX[k] - cx;
+            T ey = maxY[k] - cy;
+            T ez = maxZ[k] - cz;
+
+            int out = (maxX[k] < minX[k]) | (maxY[k] < minY[k]) | (maxZ[k] < minZ[k]);
+
+            for (int p = 0; p < 6; ++p)
+            {
+                T d = nx[p] * cx + ny[p] * cy + nz[p] * cz;
+
+                if (Contains)
+                    d = d + ax[p] * ex + ay[p] * ey + az[p] * ez - o[p];
+                else
+                    d = d - ax[p] * ex - ay[p] * ey - az[p] * ez - o[p];
+
+                out |= d >= 0;
+            }
+
+            outside[i] = out;
+        }
+
+        uint64_t word = 0;
+
+        for (size_t i = 0; i < m; ++i)
+            word |= uint64_t (outside[i] ^ 1) << i;
+
+        for (size_t i = 0; i < m; ++i)
+            count += size_t (outside[i] ^ 1);
+
+        bits[b / blockSize] = word;
+    }
+
+    return count;
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::isVisible (const T* IMATH_RESTRICT minX,
+                           const T* IMATH_RESTRICT minY,
+                           const T* IMATH_RESTRICT minZ,
+                           const T* IMATH_RESTRICT maxX,
+                           const T* IMATH_RESTRICT maxY,
+                           const T* IMATH_RESTRICT maxZ,
+                           size_t n,
+                           uint64_t* IMATH_RESTRICT visible) const noexcept
+{
+    return testBoxes<false> (minX, minY, minZ, maxX, maxY, maxZ, n, visible);
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::completelyContains (const T* IMATH_RESTRICT minX,
+                                    const T* IMATH_RESTRICT minY,
+                                    const T* IMATH_RESTRICT minZ,
+                                    const T* IMATH_RESTRICT maxX,
+                                    const T* IMATH_RESTRICT maxY,
+                                    const T* IMATH_RESTRICT maxZ,
+                                    size_t n,
+                                    uint64_t* IMATH_RESTRICT contained) const noexcept
+{
+    return testBoxes<true> (minX, minY, minZ, maxX, maxY, maxZ, n, contained);
+}
+
+template <typename T>
+template <bool Visible, bool Contained>
+void
+FrustumTest<T>::testSpheres (const T* IMATH_RESTRICT centerX,
+                             const T* IMATH_RESTRICT centerY,
+                             const T* IMATH_RESTRICT centerZ,
+                             const T* IMATH_RESTRICT radius,
+                             size_t n,
+                             uint64_t* IMATH_RESTRICT visible,
+                             uint64_t* IMATH_RESTRICT contained,
+                             size_t& numVisible,
+                             size_t& numContained) const noexcept
+{
+    //
+    // As in testBoxes(), with the distance of each center to each
+    // plane offset by the radius.
+    //
+
+    T nx[6], ny[6], nz[6], o[6];
+
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            nx[i * 3 + j] = planeNormX[i][j];
+            ny[i * 3 + j] = planeNormY[i][j];
+            nz[i * 3 + j] = planeNormZ[i][j];
+            o[i * 3 + j]  = planeOffsetVec[i][j];
+        }
+    }
+
+    const size_t blockSize = 64;
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        int outside[blockSize];
+        int notInside[blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t k = b + i;
+
+            int out   = 0;
+            int notIn = 0;
+
+            for (int p = 0; p < 6; ++p)
+            {
+                T d = nx[p] * centerX[k] + ny[p] * centerY[k] + nz[p] * centerZ[k];
+
+                if (Visible)
+                    out |= d - radius[k] - o[p] >= 0;
+
+                if (Contained)
+                    notIn |= d + radius[k] - o[p] >= 0;
+            }
+
+            outside[i]   = out;
+            notInside[i] = notIn;
+        }
+
+        if (Visible)
+        {
+            uint64_t word = 0;
+
+            for (size_t i = 0; i < m; ++i)
+                word |= uint64_t (outside[i] ^ 1) << i;
+
+            for (size_t i = 0; i < m; ++i)
+                numVisible += size_t (outside[i] ^ 1);
+
+            visible[b / blockSize] = word;
+        }
+
+        if (Contained)
+        {
+            uint64_t word = 0;
+
+            for (size_t i = 0; i < m; ++i)
+                word |= uint64_t (notInside[i] ^ 1) << i;
+
+            for (size_t i = 0; i < m; ++i)
+                numContained += size_t (notInside[i] ^ 1);
+
+            contained[b / blockSize] = word;
+        }
+    }
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::isVisible (const T* IMATH_RESTRICT centerX,
+                           const T* IMATH_RESTRICT centerY,
+                           const T* IMATH_RESTRICT centerZ,
+                           const T* IMATH_RESTRICT radius,
+                           size_t n,
+                           uint64_t* IMATH_RESTRICT visible) const noexcept
+{
+    size_t numVisible = 0, numContained = 0;
+    testSpheres<true, false> (
+        centerX, centerY, centerZ, radius, n, visible, nullptr, numVisible, numContained);
+    return numVisible;
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::completelyContains (const T* IMATH_RESTRICT centerX,
+                                    const T* IMATH_RESTRICT centerY,
+                                    const T* IMATH_RESTRICT centerZ,
+                                    const T* IMATH_RESTRICT radius,
+                                    size_t n,
+                                    uint64_t* IMATH_RESTRICT contained) const noexcept
+{
+    size_t numVisible = 0, numContained = 0;
+    testSpheres<false, true> (
+        centerX, centerY, centerZ, radius, n, nullptr, contained, numVisible, numContained);
+    return numContained;
+}
+
+template <typename T>
+size_t
+FrustumTest<T>::classify (const T* IMATH_RESTRICT centerX,
+                          const T* IMATH_RESTRICT centerY,
+                          const T* IMATH_RESTRICT centerZ,
+                          const T* IMATH_RESTRICT radius,
+                          size_t n,
+                          uint64_t* IMATH_RESTRICT visible,
+                          uint64_t* IMATH_RESTRICT contained) const noexcept
+{
+    size_t numVisible = 0, numContained = 0;
+    testSpheres<true, true> (
+        centerX, centerY, centerZ, radius, n, visible, contained, numVisible, numContained);
+    return numVisible;
+}
+
 /// FrustymTest of type float
 typedef FrustumTest<float> FrustumTestf;
 
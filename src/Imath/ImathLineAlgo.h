@@ -13,8 +13,12 @@
 #include "ImathFun.h"
 #include "ImathLine.h"
 #include "ImathNamespace.h"
+#include "ImathPlatform.h"
 #include "ImathVecAlgo.h"
 
+#include <cstddef>
+#include <limits>
+
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
 ///
@@ -51,6 +55,221 @@ closestPoints (const Line3<T>& line1, const Line3<T>& line2, Vec3<T>& point1, Ve
     }
 }
 
+/// @cond Doxygen_Suppress
+//
+// The parameters t1[i] and t2[i] of the closest points line1(t1[i])
+// and line(i)(t2[i]) of line1 and each of the n <= 64 lines given
+// as in the batched closestPoints(), computed as by closestPoints().
+// For parallel lines, t1[i] is 0 and t2[i] is the parameter of the
+// closest point to line1.pos. The numerators and divisors, rather
+// than the quotients, are selected, and divided in a separate pass,
+// which lets both loops be vectorized.
+//
+
+template <class T>
+inline void
+closestPointParameters (const Vec3<T>& pos1,
+                        const Vec3<T>& dir1,
+                        const T* IMATH_RESTRICT posX,
+                        const T* IMATH_RESTRICT posY,
+                        const T* IMATH_RESTRICT posZ,
+                        const T* IMATH_RESTRICT dirX,
+                        const T* IMATH_RESTRICT dirY,
+                        const T* IMATH_RESTRICT dirZ,
+                        size_t n,
+                        T* IMATH_RESTRICT t1,
+                        T* IMATH_RESTRICT t2) noexcept
+{
+    T num1[64], num2[64], divisor[64];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> dir2 (dirX[i], dirY[i], dirZ[i]);
+        Vec3<T> w = pos1 - Vec3<T> (posX[i], posY[i], posZ[i]);
+        T d1w     = dir1 ^ w;
+        T d2w     = dir2 ^ w;
+        T d1d2    = dir1 ^ dir2;
+        T n1      = d1d2 * d2w - d1w;
+        T n2      = d2w - d1d2 * d1w;
+        T d       = 1 - d1d2 * d1d2;
+        T absD    = abs (d);
+
+        const T limit = std::numeric_limits<T>::max() * absD;
+        bool found    = (absD > 1) | ((abs (n1) < limit) & (abs (n2) < limit));
+
+        num1[i]    = found ? n1 : T (0);
+        num2[i]    = found ? n2 : d2w;
+        divisor[i] = found ? d : T (1);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        t1[i] = num1[i] / divisor[i];
+        t2[i] = num2[i] / divisor[i];
+    }
+}
+
+/// @endcond
+
+///
+/// For each of the `n` lines with positions `(posX[i], posY[i],
+/// posZ[i])` and directions `(dirX[i], dirY[i], dirZ[i])`, compute
+/// the parameters `t1[i]` and `t2[i]` of the closest points
+/// `line (t1[i])` on `line` and `pos + t2[i] * dir` on line `i`, as
+/// closestPoints() does. Parallel or nearly parallel lines, for which
+/// closestPoints() returns false, are equally close everywhere; for
+/// them, `t1[i]` is 0 and `t2[i]` is the parameter of the point
+/// closest to `line.pos`. Like closestPoints(), this assumes that the
+/// directions are normalized.
+///
+/// The lines are infinite: the parameters are not clamped, so line
+/// segments are not supported.
+///
+
+template <class T>
+void
+closestPoints (const Line3<T>& line,
+               const T* IMATH_RESTRICT posX,
+               const T* IMATH_RESTRICT posY,
+               const T* IMATH_RESTRICT posZ,
+               const T* IMATH_RESTRICT dirX,
+               const T* IMATH_RESTRICT dirY,
+               const T* IMATH_RESTRICT dirZ,
+               size_t n,
+               T* IMATH_RESTRICT t1,
+               T* IMATH_RESTRICT t2) noexcept
+{
+    //
+    // The parameters are computed in blocks, which bounds the local
+    // arrays of closestPointParameters().
+    //
+
+    const Vec3<T> pos      = line.pos;
+    const Vec3<T> dir      = line.dir;
+    const size_t blockSize = 64;
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+
+        closestPointParameters (pos,
+                                dir,
+                                posX + b,
+                                posY + b,
+                                posZ + b,
+                                dirX + b,
+                                dirY + b,
+                                dirZ + b,
+                                m,
+                                t1 + b,
+                                t2 + b);
+    }
+}
+
+///
+/// Return the index of the one of the `n` lines, given as for the
+/// batched closestPoints(), that comes closest to `line`, or -1 if
+/// `n` is 0. The closest points on `line` and on that line are
+/// returned in `point1` and `point2`. Of equally close lines, the
+/// first is returned. As for the batched closestPoints(), the lines
+/// are infinite; line segments are not supported.
+///
+
+template <class T>
+int
+closestLine (const Line3<T>& line,
+             const T* IMATH_RESTRICT posX,
+             const T* IMATH_RESTRICT posY,
+             const T* IMATH_RESTRICT posZ,
+             const T* IMATH_RESTRICT dirX,
+             const T* IMATH_RESTRICT dirY,
+             const T* IMATH_RESTRICT dirZ,
+             size_t n,
+             Vec3<T>& point1,
+             Vec3<T>& point2) noexcept
+{
+    const Vec3<T> pos      = line.pos;
+    const Vec3<T> dir      = line.dir;
+    const size_t blockSize = 64;
+
+    int nearest = -1;
+    T nearestD2 = std::numeric_limits<T>::infinity();
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        T t1[blockSize], t2[blockSize], d2[blockSize];
+
+        closestPointParameters (pos,
+                                dir,
+                                posX + b,
+                                posY + b,
+                                posZ + b,
+                                dirX + b,
+                                dirY + b,
+                                dirZ + b,
+                                m,
+                                t1,
+                                t2);
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t k = b + i;
+
+            Vec3<T> p (posX[k], posY[k], posZ[k]);
+            Vec3<T> d (dirX[k], dirY[k], dirZ[k]);
+
+            d2[i] = ((pos + dir * t1[i]) - (p + d * t2[i])).length2();
+        }
+
+        //
+        // Only look for the index of the nearest line of the block if
+        // it is nearer than the nearest line so far.
+        //
+
+        T blockMin = nearestD2;
+
+        for (size_t i = 0; i < m; ++i)
+            blockMin = d2[i] < blockMin ? d2[i] : blockMin;
+
+        if (blockMin < nearestD2 || nearest < 0)
+        {
+            for (size_t i = 0; i < m; ++i)
+            {
+                if (d2[i] == blockMin)
+                {
+                    nearest   = int (b + i);
+                    nearestD2 = blockMin;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (nearest >= 0)
+    {
+        Vec3<T> p (posX[nearest], posY[nearest], posZ[nearest]);
+        Vec3<T> d (dirX[nearest], dirY[nearest], dirZ[nearest]);
+        T t1, t2;
+
+        closestPointParameters (pos,
+                                dir,
+                                posX + nearest,
+                                posY + nearest,
+                                posZ + nearest,
+                                dirX + nearest,
+                                dirY + nearest,
+                                dirZ + nearest,
+                                1,
+                                &t1,
+                                &t2);
+        point1 = pos + dir * t1;
+        point2 = p + d * t2;
+    }
+
+    return nearest;
+}
+
 ///
 /// Given a line and a triangle (v0, v1, v2), the intersect() function
 /// finds the intersection of the line and the plane that contains the
@@ -154,6 +373,223 @@ intersect (const Line3<T>& line,
     return true;
 }
 
+/// @cond Doxygen_Suppress
+//
+// The Moller-Trumbore ray-triangle test, returning whether the ray
+// hits the triangle at or after its origin: t is the distance along the
+// ray to the hit, in units of the direction's length, or infinity if
+// the ray misses the triangle or hits it behind its origin, and the
+// barycentric coordinates of the hit are (1 - u - v, u, v). A zero
+// determinant, for a ray in the plane of the triangle or a
+// degenerate triangle, makes invDet infinite and the coordinates
+// infinite or NaN, which fail the comparisons.
+//
+
+template <class T>
+inline bool
+mollerTrumbore (const Vec3<T>& pos,
+                const Vec3<T>& dir,
+                const Vec3<T>& v0,
+                const Vec3<T>& v1,
+                const Vec3<T>& v2,
+                T& t,
+                T& u,
+                T& v) noexcept
+{
+    Vec3<T> edge1 = v1 - v0;
+    Vec3<T> edge2 = v2 - v0;
+    Vec3<T> q     = dir % edge2;
+    Vec3<T> s     = pos - v0;
+    Vec3<T> r     = s % edge1;
+
+    T det    = edge1 ^ q;
+    T invDet = T (1) / det;
+
+    T b1   = (s ^ q) * invDet;
+    T b2   = (dir ^ r) * invDet;
+    T tHit = (edge2 ^ r) * invDet;
+
+    bool hit = (det != 0) & (b1 >= 0) & (b2 >= 0) & (b1 + b2 <= 1) & (tHit >= 0);
+
+    t = hit ? tHit : std::numeric_limits<T>::infinity();
+    u = b1;
+    v = b2;
+    return hit;
+}
+
+/// @endcond
+
+///
+/// Intersect the ray `ray` with the `n` triangles whose vertices are
+/// `(v0x[i], v0y[i], v0z[i])`, `(v1x[i], v1y[i], v1z[i])` and
+/// `(v2x[i], v2y[i], v2z[i])`, and return the index of the triangle
+/// that the ray hits first, or -1 if the ray hits none of them.
+///
+/// Unlike the single-triangle intersect(), which intersects a line,
+/// only the hits at or after the ray's origin count. The distance
+/// along the ray to the hit, `ray.pos + t * ray.dir`, is returned in
+/// `t`, and its barycentric coordinates, with the same property as
+/// those of the single-triangle intersect(), in `barycentric`. A ray
+/// in the plane of a triangle misses it.
+///
+/// The triangles are tested with the Moller-Trumbore algorithm,
+/// without branches, so that the loop over the triangles vectorizes.
+/// The test is not watertight: because of rounding, a ray through
+/// the shared edge of two triangles may hit either, both or neither
+/// of them.
+///
+
+template <class T>
+int
+intersect (const Line3<T>& ray,
+           const T* IMATH_RESTRICT v0x,
+           const T* IMATH_RESTRICT v0y,
+           const T* IMATH_RESTRICT v0z,
+           const T* IMATH_RESTRICT v1x,
+           const T* IMATH_RESTRICT v1y,
+           const T* IMATH_RESTRICT v1z,
+           const T* IMATH_RESTRICT v2x,
+           const T* IMATH_RESTRICT v2y,
+           const T* IMATH_RESTRICT v2z,
+           size_t n,
+           T& t,
+           Vec3<T>& barycentric) noexcept
+{
+    const T inf            = std::numeric_limits<T>::infinity();
+    const size_t blockSize = 64;
+
+    int nearest = -1;
+    t           = inf;
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        T blockT[blockSize], blockU[blockSize], blockV[blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t k = b + i;
+
+            mollerTrumbore (ray.pos,
+                            ray.dir,
+                            Vec3<T> (v0x[k], v0y[k], v0z[k]),
+                            Vec3<T> (v1x[k], v1y[k], v1z[k]),
+                            Vec3<T> (v2x[k], v2y[k], v2z[k]),
+                            blockT[i],
+                            blockU[i],
+                            blockV[i]);
+        }
+
+        //
+        // Find the nearest hit of the block, and only look for its
+        // index if it is nearer than the nearest hit so far.
+        //
+
+        T blockMin = inf;
+
+        for (size_t i = 0; i < m; ++i)
+            blockMin = blockT[i] < blockMin ? blockT[i] : blockMin;
+
+        if (blockMin < t)
+        {
+            for (size_t i = 0; i < m; ++i)
+            {
+                if (blockT[i] == blockMin)
+                {
+                    nearest       = int (b + i);
+                    t             = blockMin;
+                    barycentric.x = 1 - blockU[i] - blockV[i];
+                    barycentric.y = blockU[i];
+                    barycentric.z = blockV[i];
+                    break;
+                }
+            }
+        }
+    }
+
+    return nearest;
+}
+
+///
+/// Intersect the `n` rays with origins `(posX[i], posY[i], posZ[i])`
+/// and directions `(dirX[i], dirY[i], dirZ[i])` with the triangle
+/// (v0, v1, v2), and return the number of rays that hit it.
+///
+/// `hits[i]` is set to whether ray `i` hits the triangle at or after
+/// its origin, as for the one-ray, many-triangle intersect(). The hit
+/// is at `pos + t[i] * dir`, and its barycentric coordinates are
+/// `(1 - u[i] - v[i], u[i], v[i])`. For a ray that misses, `t[i]` is
+/// infinite and `u[i]` and `v[i]` are unspecified.
+///
+
+template <class T>
+size_t
+intersect (const Vec3<T>& v0,
+           const Vec3<T>& v1,
+           const Vec3<T>& v2,
+           const T* IMATH_RESTRICT posX,
+           const T* IMATH_RESTRICT posY,
+           const T* IMATH_RESTRICT posZ,
+           const T* IMATH_RESTRICT dirX,
+           const T* IMATH_RESTRICT dirY,
+           const T* IMATH_RESTRICT dirZ,
+           size_t n,
+           bool* IMATH_RESTRICT hits,
+           T* IMATH_RESTRICT t,
+           T* IMATH_RESTRICT u,
+           T* IMATH_RESTRICT v) noexcept
+{
+    //
+    // The rays are intersected in blocks, into local arrays that
+    // cannot alias the rays, and the results are then copied out,
+    // which keeps the number of pointers that the vectorized loops
+    // must be checked against small.
+    //
+
+    const Vec3<T> a = v0;
+    const Vec3<T> b = v1;
+    const Vec3<T> c = v2;
+
+    const size_t blockSize = 64;
+    size_t numHits         = 0;
+
+    for (size_t j = 0; j < n; j += blockSize)
+    {
+        size_t m = n - j < blockSize ? n - j : blockSize;
+        T blockT[blockSize], blockU[blockSize], blockV[blockSize];
+        int blockHit[blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t k = j + i;
+
+            blockHit[i] = mollerTrumbore (Vec3<T> (posX[k], posY[k], posZ[k]),
+                                          Vec3<T> (dirX[k], dirY[k], dirZ[k]),
+                                          a,
+                                          b,
+                                          c,
+                                          blockT[i],
+                                          blockU[i],
+                                          blockV[i]);
+        }
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            t[j + i] = blockT[i];
+            u[j + i] = blockU[i];
+            v[j + i] = blockV[i];
+        }
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            hits[j + i] = blockHit[i] != 0;
+            numHits += blockHit[i];
+        }
+    }
+
+    return numHits;
+}
+
 ///
 /// Return the vertex that is closest to the given line. The returned
 /// point is either v0, v1, or v2.
@@ -184,6 +620,62 @@ closestVertex (const Vec3<T>& v0, const Vec3<T>& v1, const Vec3<T>& v2, const Li
     return nearest;
 }
 
+///
+/// Return the index of the one of the `n` points `(x[i], y[i], z[i])`
+/// that is closest to the line `l`, or -1 if `n` is 0. Of equally
+/// close points, the first is returned, so that for the three
+/// vertices of a triangle, the result is the vertex that
+/// closestVertex() returns.
+///
+
+template <class T>
+int
+closestVertex (const T* IMATH_RESTRICT x,
+               const T* IMATH_RESTRICT y,
+               const T* IMATH_RESTRICT z,
+               size_t n,
+               const Line3<T>& l) noexcept
+{
+    const Vec3<T> pos      = l.pos;
+    const Vec3<T> dir      = l.dir;
+    const size_t blockSize = 64;
+
+    int nearest = -1;
+    T nearestD2 = std::numeric_limits<T>::infinity();
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        T d2[blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            Vec3<T> v (x[b + i], y[b + i], z[b + i]);
+            d2[i] = (v - (((v - pos) ^ dir) * dir + pos)).length2();
+        }
+
+        T blockMin = nearestD2;
+
+        for (size_t i = 0; i < m; ++i)
+            blockMin = d2[i] < blockMin ? d2[i] : blockMin;
+
+        if (blockMin < nearestD2 || nearest < 0)
+        {
+            for (size_t i = 0; i < m; ++i)
+            {
+                if (d2[i] == blockMin)
+                {
+                    nearest   = int (b + i);
+                    nearestD2 = blockMin;
+                    break;
+                }
+            }
+        }
+    }
+
+    return nearest;
+}
+
 ///
 /// Rotate the point p around the line l by the given angle.
 ///
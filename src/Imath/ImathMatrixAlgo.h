@@ -174,6 +174,34 @@ template <class T> void extractEulerZYX (const Matrix44<T>& mat, Vec3<T>& rot);
 /// @return The extracted quaternion
 template <class T> Quat<T> extractQuat (const Matrix44<T>& mat);
 
+/// Extract the rotations from an array of 4x4 matrices in the form of
+/// quaternions, stored as separate arrays of their real parts and
+/// imaginary components.  Quaternion `i` is the same as
+/// `extractQuat (mat[i])`.  The separate arrays can be passed
+/// straight to the structure-of-arrays `quatToMatrix44()` or to other
+/// code that works on one component at a time.  This is not faster
+/// than calling `extractQuat()` on each matrix: the square root keeps
+/// the loop from being vectorized with the default floating-point
+/// options.
+///
+/// @param[in] mat The input matrices
+/// @param[in] n The number of matrices
+/// @param[out] r The extracted real parts
+/// @param[out] x The extracted imaginary x components
+/// @param[out] y The extracted imaginary y components
+/// @param[out] z The extracted imaginary z components
+template <class T>
+void extractQuat (const Matrix44<T>* mat, size_t n, T* r, T* x, T* y, T* z) noexcept;
+
+/// Extract the rotations from an array of 4x4 matrices in the form of
+/// quaternions, setting `result[i]` to `extractQuat (mat[i])`.
+///
+/// @param[in] mat The input matrices
+/// @param[in] n The number of matrices
+/// @param[out] result The extracted quaternions
+template <class T>
+void extractQuat (const Matrix44<T>* mat, size_t n, Quat<T>* result) noexcept;
+
 /// Extract the scaling, shear, rotation, and translation components
 /// of the given 4x4 matrix. The values are such that:
 ///
@@ -232,6 +260,103 @@ bool extractSHRT (const Matrix44<T>& mat,
                   Vec3<T>& t,
                   bool exc = true);
 
+/// Extract the scaling, shear, rotation, and translation components
+/// of the given 4x4 matrix, with the rotation as a unit quaternion.
+///
+/// @param[in] mat The input matrix
+/// @param[out] s The extracted scale
+/// @param[out] h The extracted shear
+/// @param[out] r The extracted rotation, as a quaternion
+/// @param[out] t The extracted translation
+/// @param[in] exc If true, throw an exception if the scaling in `mat` is very close to zero.
+/// @return True if the values could be extracted, false if the matrix is degenerate.
+template <class T>
+bool extractSHRT (const Matrix44<T>& mat,
+                  Vec3<T>& s,
+                  Vec3<T>& h,
+                  Quat<T>& r,
+                  Vec3<T>& t,
+                  bool exc = true);
+
+///
+/// The SHRTInterpolator class interpolates between two 4x4 matrix
+/// keys, for example the transforms at shutter open and shutter
+/// close.  Both keys are decomposed with extractSHRT() once, when
+/// they are set, and the angle between the two rotations is cached,
+/// so evaluating the interpolated matrix at any number of times
+/// costs no further decomposition and no inverse trigonometry.
+///
+/// Scale, shear and translation are interpolated linearly; the
+/// rotation is interpolated with slerp() along the shortest arc.
+/// The result is recomposed as M = S * H * R * T.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE SHRTInterpolator
+{
+  public:
+
+    /// @{
+    /// @name Direct access to the decomposed keys
+
+    /// Scale, shear, rotation and translation of the first key
+    Vec3<T> s0, h0;
+    Quat<T> r0;
+    Vec3<T> t0;
+
+    /// Scale, shear, rotation and translation of the second key.
+    /// `r1` is flipped, if necessary, to lie on the same hemisphere
+    /// as `r0`.
+    Vec3<T> s1, h1;
+    Quat<T> r1;
+    Vec3<T> t1;
+
+    /// @}
+
+    /// Initialize both keys to the identity
+    SHRTInterpolator() noexcept;
+
+    /// Initialize with the keys `m0` and `m1`. If `exc` is true,
+    /// throw an exception if either key's scaling is very close to
+    /// zero; otherwise, both keys are left as the identity.
+    SHRTInterpolator (const Matrix44<T>& m0, const Matrix44<T>& m1, bool exc = true);
+
+    /// Decompose and cache the keys `m0` and `m1`.
+    /// @return True if both keys could be decomposed, false if either
+    /// is degenerate, in which case both keys are reset to the
+    /// identity.
+    bool setKeys (const Matrix44<T>& m0, const Matrix44<T>& m1, bool exc = true);
+
+    /// Return the matrix interpolated at time `t`, where 0 yields the
+    /// first key and 1 the second.
+    Matrix44<T> interpolate (T t) const noexcept;
+
+    /// Evaluate the interpolated matrix at the `n` times `t[i]`,
+    /// storing the results in `result[i]`.
+    void interpolate (const T* t, size_t n, Matrix44<T>* result) const noexcept;
+
+  private:
+
+    T _angle;
+    T _invSinc;
+};
+
+/// Evaluate `n` interpolators at the same time `t`, storing the
+/// result of `interps[i]` in `result[i]`.
+template <class T>
+void interpolateSHRT (const SHRTInterpolator<T>* interps,
+                      size_t n,
+                      T t,
+                      Matrix44<T>* result) noexcept;
+
+/// Evaluate `n` interpolators at each of `numTimes` times, storing
+/// the result of `interps[i]` at `times[j]` in `result[j * n + i]`.
+template <class T>
+void interpolateSHRT (const SHRTInterpolator<T>* interps,
+                      size_t n,
+                      const T* times,
+                      size_t numTimes,
+                      Matrix44<T>* result) noexcept;
+
 /// Return true if the given scale can be removed from the given row
 /// matrix, false if `scl` is small enough that the operation would
 /// overflow. If `exc` is true, throw an exception on overflow.
@@ -772,6 +897,85 @@ extractQuat (const Matrix44<T>& mat)
     return quat;
 }
 
+template <class T>
+void
+extractQuat (const Matrix44<T>* IMATH_RESTRICT mat,
+             size_t n,
+             T* IMATH_RESTRICT r,
+             T* IMATH_RESTRICT x,
+             T* IMATH_RESTRICT y,
+             T* IMATH_RESTRICT z) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const Matrix44<T>& m = mat[i];
+
+        //
+        // Select the same case as extractQuat() above: the trace if it
+        // is positive, otherwise the largest diagonal element, with
+        // ties going to the first.
+        //
+
+        T tr      = m[0][0] + m[1][1] + m[2][2];
+        bool useR = tr > 0.0;
+        bool useY = m[1][1] > m[0][0];
+        bool useZ = m[2][2] > (useY ? m[1][1] : m[0][0]);
+        useY      = useY & !useZ;
+        bool useX = !useY & !useZ;
+
+        T tr1 = tr + T (1.0);
+        T tx1 = (m[0][0] - (m[1][1] + m[2][2])) + T (1.0);
+        T ty1 = (m[1][1] - (m[2][2] + m[0][0])) + T (1.0);
+        T tz1 = (m[2][2] - (m[0][0] + m[1][1])) + T (1.0);
+
+        T t = useR ? tr1 : useX ? tx1 : useY ? ty1 : tz1;
+
+        //
+        // All terms are computed unconditionally, and the division
+        // can't be by zero.
+        //
+
+        T rs = std::sqrt (t);
+        T h  = rs * T (0.5);
+        T s  = (rs != T (0.0) ? T (0.5) : T (0.0)) / (rs != T (0.0) ? rs : T (1.0));
+
+        T dx  = (m[1][2] - m[2][1]) * s;
+        T dy  = (m[2][0] - m[0][2]) * s;
+        T dz  = (m[0][1] - m[1][0]) * s;
+        T sxy = (m[0][1] + m[1][0]) * s;
+        T sxz = (m[0][2] + m[2][0]) * s;
+        T syz = (m[1][2] + m[2][1]) * s;
+
+        r[i] = useR ? h : useX ? dx : useY ? dy : dz;
+        x[i] = useR ? dx : useX ? h : useY ? sxy : sxz;
+        y[i] = useR ? dy : useX ? sxy : useY ? h : syz;
+        z[i] = useR ? dz : useX ? sxz : useY ? syz : h;
+    }
+}
+
+template <class T>
+void
+extractQuat (const Matrix44<T>* mat, size_t n, Quat<T>* result) noexcept
+{
+    //
+    // Convert in blocks through a small structure-of-arrays buffer,
+    // so the select-based loop above does the work.
+    //
+
+    const size_t block = 64;
+    T r[block], x[block], y[block], z[block];
+
+    for (size_t i = 0; i < n; i += block)
+    {
+        size_t m = n - i < block ? n - i : block;
+
+        extractQuat (mat + i, m, r, x, y, z);
+
+        for (size_t j = 0; j < m; ++j)
+            result[i + j] = Quat<T> (r[j], x[j], y[j], z[j]);
+    }
+}
+
 template <class T>
 bool
 extractSHRT (const Matrix44<T>& mat,
@@ -823,6 +1027,134 @@ extractSHRT (const Matrix44<T>& mat,
     return extractSHRT (mat, s, h, r, t, exc, r.order());
 }
 
+template <class T>
+bool
+extractSHRT (const Matrix44<T>& mat, Vec3<T>& s, Vec3<T>& h, Quat<T>& r, Vec3<T>& t, bool exc)
+{
+    Matrix44<T> rot;
+
+    rot = mat;
+    if (!extractAndRemoveScalingAndShear (rot, s, h, exc))
+        return false;
+
+    r = extractQuat (rot).normalized();
+
+    t.x = mat[3][0];
+    t.y = mat[3][1];
+    t.z = mat[3][2];
+
+    return true;
+}
+
+template <class T>
+inline SHRTInterpolator<T>::SHRTInterpolator() noexcept
+    : s0 (1), h0 (0), r0(), t0 (0), s1 (1), h1 (0), r1(), t1 (0), _angle (0), _invSinc (1)
+{
+    // empty
+}
+
+template <class T>
+inline SHRTInterpolator<T>::SHRTInterpolator (const Matrix44<T>& m0, const Matrix44<T>& m1, bool exc)
+    : SHRTInterpolator()
+{
+    setKeys (m0, m1, exc);
+}
+
+template <class T>
+bool
+SHRTInterpolator<T>::setKeys (const Matrix44<T>& m0, const Matrix44<T>& m1, bool exc)
+{
+    if (!extractSHRT (m0, s0, h0, r0, t0, exc) || !extractSHRT (m1, s1, h1, r1, t1, exc))
+    {
+        *this = SHRTInterpolator();
+        return false;
+    }
+
+    //
+    // Interpolate along the shortest arc, as slerpShortestArc() does,
+    // and cache the terms of slerp() that don't depend on the time.
+    //
+
+    if ((r0 ^ r1) < 0)
+        r1 = -r1;
+
+    _angle   = angle4D (r0, r1);
+    _invSinc = 1 / sinx_over_x (_angle);
+
+    return true;
+}
+
+template <class T>
+inline Matrix44<T>
+SHRTInterpolator<T>::interpolate (T t) const noexcept
+{
+    T u = 1 - t;
+
+    //
+    // slerp (r0, r1, t), with the angle between r0 and r1 precomputed
+    //
+
+    Quat<T> q = (sinx_over_x (u * _angle) * _invSinc * u) * r0 +
+                (sinx_over_x (t * _angle) * _invSinc * t) * r1;
+
+    q.normalize();
+
+    Vec3<T> s = u * s0 + t * s1;
+    Vec3<T> h = u * h0 + t * h1;
+    Vec3<T> p = u * t0 + t * t1;
+
+    //
+    // Rows of S * H * R, computed directly rather than by multiplying
+    // matrices.  This matches M.translate(p); M = R * M; M.shear(h);
+    // M.scale(s).
+    //
+
+    Matrix33<T> R = q.toMatrix33();
+
+    Vec3<T> x (R[0][0], R[0][1], R[0][2]);
+    Vec3<T> y (R[1][0], R[1][1], R[1][2]);
+    Vec3<T> z (R[2][0], R[2][1], R[2][2]);
+
+    z = s.z * (z + h.y * x + h.z * y);
+    y = s.y * (y + h.x * x);
+    x = s.x * x;
+
+    return Matrix44<T> (x.x, x.y, x.z, 0, y.x, y.y, y.z, 0, z.x, z.y, z.z, 0, p.x, p.y, p.z, 1);
+}
+
+template <class T>
+void
+SHRTInterpolator<T>::interpolate (const T* t, size_t n, Matrix44<T>* result) const noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = interpolate (t[i]);
+}
+
+template <class T>
+void
+interpolateSHRT (const SHRTInterpolator<T>* interps, size_t n, T t, Matrix44<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = interps[i].interpolate (t);
+}
+
+template <class T>
+void
+interpolateSHRT (const SHRTInterpolator<T>* interps,
+                 size_t n,
+                 const T* times,
+                 size_t numTimes,
+                 Matrix44<T>* result) noexcept
+{
+    //
+    // Time-major, so each pass streams through the interpolators
+    // once with a loop-invariant time.
+    //
+
+    for (size_t j = 0; j < numTimes; ++j)
+        interpolateSHRT (interps, n, times[j], result + j * n);
+}
+
 template <class T>
 bool
 checkForZeroScaleInRow (const T& scl, const Vec3<T>& row, bool exc /* = true */)
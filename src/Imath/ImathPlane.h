@@ -14,8 +14,12 @@
 #include "ImathNamespace.h"
 
 #include "ImathLine.h"
+#include "ImathPlatform.h"
 #include "ImathVec.h"
 
+#include <cstddef>
+#include <cstdint>
+
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
 ///
@@ -95,6 +99,29 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Plane3
     /// Return the distance from a point to the plane.
     IMATH_HOSTDEVICE constexpr T distanceTo (const Vec3<T>& point) const noexcept;
 
+    /// Set `distances[i]` to the distance from the point `(x[i],
+    /// y[i], z[i])` to the plane, for each of the `n` points, as
+    /// `distanceTo(Vec3<T>)` does.
+    void distanceTo (const T* IMATH_RESTRICT x,
+                     const T* IMATH_RESTRICT y,
+                     const T* IMATH_RESTRICT z,
+                     size_t n,
+                     T* IMATH_RESTRICT distances) const noexcept;
+
+    /// Classify `n` points by the side of the plane that they are
+    /// on, setting `distances[i]` as the batched `distanceTo()` does.
+    /// Bit `i % 64` of `above[i / 64]` is set if point `i` is above
+    /// the plane, in the half space that the normal points into,
+    /// that is, if its distance is positive; the unused bits of the
+    /// last word are cleared. `above` must hold `(n + 63) / 64`
+    /// words. Return the number of points above the plane.
+    size_t classify (const T* IMATH_RESTRICT x,
+                     const T* IMATH_RESTRICT y,
+                     const T* IMATH_RESTRICT z,
+                     size_t n,
+                     T* IMATH_RESTRICT distances,
+                     uint64_t* IMATH_RESTRICT above) const noexcept;
+
     /// Reflect the given point around the plane.
     IMATH_HOSTDEVICE constexpr Vec3<T> reflectPoint (const Vec3<T>& point) const noexcept;
 
@@ -164,6 +191,64 @@ Plane3<T>::distanceTo (const Vec3<T>& point) const noexcept
     return (point ^ normal) - distance;
 }
 
+template <class T>
+void
+Plane3<T>::distanceTo (const T* IMATH_RESTRICT x,
+                       const T* IMATH_RESTRICT y,
+                       const T* IMATH_RESTRICT z,
+                       size_t n,
+                       T* IMATH_RESTRICT distances) const noexcept
+{
+    const Vec3<T> nn = normal;
+    const T d        = distance;
+
+    for (size_t i = 0; i < n; ++i)
+        distances[i] = (x[i] * nn.x + y[i] * nn.y + z[i] * nn.z) - d;
+}
+
+template <class T>
+size_t
+Plane3<T>::classify (const T* IMATH_RESTRICT x,
+                     const T* IMATH_RESTRICT y,
+                     const T* IMATH_RESTRICT z,
+                     size_t n,
+                     T* IMATH_RESTRICT distances,
+                     uint64_t* IMATH_RESTRICT above) const noexcept
+{
+    const Vec3<T> nn       = normal;
+    const T d              = distance;
+    const size_t blockSize = 64;
+
+    size_t numAbove = 0;
+
+    for (size_t b = 0; b < n; b += blockSize)
+    {
+        size_t m = n - b < blockSize ? n - b : blockSize;
+        int side[blockSize];
+
+        for (size_t i = 0; i < m; ++i)
+        {
+            size_t k = b + i;
+
+            T dist       = (x[k] * nn.x + y[k] * nn.y + z[k] * nn.z) - d;
+            distances[k] = dist;
+            side[i]      = dist > 0;
+        }
+
+        uint64_t word = 0;
+
+        for (size_t i = 0; i < m; ++i)
+            word |= uint64_t (side[i]) << i;
+
+        for (size_t i = 0; i < m; ++i)
+            numAbove += size_t (side[i]);
+
+        above[b / blockSize] = word;
+    }
+
+    return numAbove;
+}
+
 template <class T>
 constexpr inline Vec3<T>
 Plane3<T>::reflectPoint (const Vec3<T>& point) const noexcept
@@ -253,6 +338,114 @@ operator- (const Plane3<T>& plane) noexcept
     return Plane3<T> (-plane.normal, -plane.distance);
 }
 
+/// @cond Doxygen_Suppress
+
+//
+// The distance from a point to a plane, or 0 if it is within the
+// rounding error of the distance and of the coordinates of the point.
+//
+
+template <class T>
+inline T
+clipDistance (const Plane3<T>& plane, const Vec3<T>& p) noexcept
+{
+    T d     = plane.distanceTo (p);
+    T scale = std::abs (p.x * plane.normal.x) + std::abs (p.y * plane.normal.y) +
+              std::abs (p.z * plane.normal.z) + std::abs (plane.distance);
+
+    return std::abs (d) <= 8 * std::numeric_limits<T>::epsilon() * scale ? T (0) : d;
+}
+
+/// @endcond
+
+///
+/// Clip the convex polygon with the `n` vertices `polygon[i]` by the
+/// `numPlanes` planes `planes[j]`, keeping the part of the polygon
+/// that is below all of the planes, on the side opposite to their
+/// normals. For the planes of `Frustum::planes()`, whose normals
+/// point out of the frustum, that is the part inside the frustum.
+/// Vertices that lie on a plane, to within the rounding error of
+/// their distance to it, are kept; a polygon in a plane is kept
+/// whole.
+///
+/// The vertices of the clipped polygon are written to `result`, in
+/// the order of the original vertices, and their number is returned;
+/// 0 if the polygon is clipped away entirely.
+///
+/// Each plane adds at most one vertex to a convex polygon, so
+/// `result` and `scratch` must each hold `n + numPlanes` vertices;
+/// no more than that are written, even if rounding makes a nearly
+/// degenerate polygon cross a plane more than twice. The buffers
+/// are used in turn as the output of the planes, and must not
+/// overlap each other or `polygon`. No memory is allocated.
+///
+
+template <class T>
+size_t
+clipPolygon (const Vec3<T>* polygon,
+             size_t n,
+             const Plane3<T>* planes,
+             size_t numPlanes,
+             Vec3<T>* result,
+             Vec3<T>* scratch) noexcept
+{
+    if (numPlanes == 0)
+    {
+        for (size_t i = 0; i < n; ++i)
+            result[i] = polygon[i];
+
+        return n;
+    }
+
+    //
+    // Sutherland-Hodgman: each plane clips the output of the
+    // previous one. The buffers alternate so that the last plane
+    // writes to result.
+    //
+
+    const size_t capacity = n + numPlanes;
+    const Vec3<T>* in     = polygon;
+    Vec3<T>* out          = (numPlanes % 2) ? result : scratch;
+
+    for (size_t j = 0; j < numPlanes && n > 0; ++j)
+    {
+        const Plane3<T>& plane = planes[j];
+        size_t m               = 0;
+
+        Vec3<T> prev = in[n - 1];
+        T prevDist   = clipDistance (plane, prev);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> cur = in[i];
+            T curDist   = clipDistance (plane, cur);
+
+            //
+            // Only an edge that properly crosses the plane adds an
+            // intersection, so that vertices on the plane are not
+            // duplicated.
+            //
+
+            bool crosses = (prevDist > 0 && curDist < 0) || (prevDist < 0 && curDist > 0);
+
+            if (crosses && m < capacity)
+                out[m++] = prev + (cur - prev) * (prevDist / (prevDist - curDist));
+
+            if (curDist <= 0 && m < capacity)
+                out[m++] = cur;
+
+            prev     = cur;
+            prevDist = curDist;
+        }
+
+        n   = m;
+        in  = out;
+        out = (out == result) ? scratch : result;
+    }
+
+    return n;
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHPLANE_H
@@ -200,6 +200,12 @@ template <class T> IMATH_CONSTEXPR14 Quat<T> slerp (const Quat<T>& q1, const Qua
 template <class T>
 IMATH_CONSTEXPR14 Quat<T> slerpShortestArc (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept;
 
+template <class T>
+IMATH_CONSTEXPR14 Quat<T> nlerp (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept;
+
+template <class T>
+IMATH_CONSTEXPR14 Quat<T> slerpFast (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept;
+
 template <class T>
 IMATH_CONSTEXPR14 Quat<T>
 squad (const Quat<T>& q1, const Quat<T>& q2, const Quat<T>& qa, const Quat<T>& qb, T t) noexcept;
@@ -535,6 +541,137 @@ slerpShortestArc (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
         return slerp (q1, -q2, t);
 }
 
+///
+/// Normalized linear interpolation along the shortest arc from q1
+/// to either q2 or -q2, whichever is closer.  Assumes q1 and q2 are
+/// unit quaternions.
+///
+/// The result follows the same path as slerpShortestArc(), but not
+/// at constant angular velocity: the rotation angle deviates from
+/// slerp's by up to about 0.14 radians for keys that are 180
+/// degrees apart.  See slerpFast() for a closer approximation at
+/// almost the same cost.
+template <class T>
+IMATH_CONSTEXPR14 inline Quat<T>
+nlerp (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
+{
+    T s = (q1 ^ q2) < 0 ? -t : t;
+    return ((1 - t) * q1 + s * q2).normalized();
+}
+
+///
+/// Fast approximation of slerpShortestArc(), without inverse
+/// trigonometry.  Assumes q1 and q2 are unit quaternions.
+///
+/// This is nlerp() with the interpolation parameter corrected by a
+/// polynomial in t and in the cosine of the angle between q1 and q2,
+/// fitted to slerp; the method is described by Arseny Kapoulkine in
+/// "Approximating slerp".  The rotation computed deviates from
+/// slerpShortestArc() by at most about 8e-4 radians (0.05 degrees),
+/// and the deviation vanishes at t = 0, 0.5 and 1.
+template <class T>
+IMATH_CONSTEXPR14 inline Quat<T>
+slerpFast (const Quat<T>& q1, const Quat<T>& q2, T t) noexcept
+{
+    T d = q1 ^ q2;
+    T c = d < 0 ? -d : d;
+
+    T a = T (1.0904) + c * (T (-3.2452) + c * (T (3.55645) - c * T (1.43519)));
+    T b = T (0.848013) + c * (T (-1.06021) + c * T (0.215638));
+    T h = t - T (0.5);
+    T u = t + t * h * (t - 1) * (a * h * h + b);
+
+    T s = d < 0 ? -u : u;
+    return ((1 - u) * q1 + s * q2).normalized();
+}
+
+///
+/// Spherical linear interpolation of arrays: `result[i]` is set to
+/// `slerp (q1[i], q2[i], t[i])` for `i` in `[0, n)`.
+template <class T>
+inline void
+slerp (const Quat<T>* q1, const Quat<T>* q2, const T* t, size_t n, Quat<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = slerp (q1[i], q2[i], t[i]);
+}
+
+///
+/// Spherical linear interpolation of arrays along the shortest arc:
+/// `result[i]` is set to `slerpShortestArc (q1[i], q2[i], t[i])`
+/// for `i` in `[0, n)`.
+template <class T>
+inline void
+slerpShortestArc (const Quat<T>* q1, const Quat<T>* q2, const T* t, size_t n, Quat<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = slerpShortestArc (q1[i], q2[i], t[i]);
+}
+
+///
+/// Normalized linear interpolation of arrays: `result[i]` is set to
+/// `nlerp (q1[i], q2[i], t[i])` for `i` in `[0, n)`.
+///
+/// The loop body is free of branches.  It is vectorized only when
+/// `std::sqrt()` need not set `errno` (e.g. with `-fno-math-errno`),
+/// not with the default floating-point options.  `result` may not
+/// alias the inputs.
+template <class T>
+inline void
+nlerp (const Quat<T>* IMATH_RESTRICT q1,
+       const Quat<T>* IMATH_RESTRICT q2,
+       const T* IMATH_RESTRICT t,
+       size_t n,
+       Quat<T>* IMATH_RESTRICT result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        T d = q1[i] ^ q2[i];
+        T u = t[i];
+        T s = d < 0 ? -u : u;
+
+        Quat<T> q = (1 - u) * q1[i] + s * q2[i];
+        T l       = 1 / std::sqrt (q ^ q);
+
+        result[i] = q * l;
+    }
+}
+
+///
+/// Fast approximate slerp of arrays: `result[i]` is set to
+/// `slerpFast (q1[i], q2[i], t[i])` for `i` in `[0, n)`, with the
+/// same accuracy.
+///
+/// The loop body is free of branches.  It is vectorized only when
+/// `std::sqrt()` need not set `errno` (e.g. with `-fno-math-errno`),
+/// not with the default floating-point options.  `result` may not
+/// alias the inputs.
+template <class T>
+inline void
+slerpFast (const Quat<T>* IMATH_RESTRICT q1,
+           const Quat<T>* IMATH_RESTRICT q2,
+           const T* IMATH_RESTRICT t,
+           size_t n,
+           Quat<T>* IMATH_RESTRICT result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        T d = q1[i] ^ q2[i];
+        T c = d < 0 ? -d : d;
+
+        T a = T (1.0904) + c * (T (-3.2452) + c * (T (3.55645) - c * T (1.43519)));
+        T b = T (0.848013) + c * (T (-1.06021) + c * T (0.215638));
+        T h = t[i] - T (0.5);
+        T u = t[i] + t[i] * h * (t[i] - 1) * (a * h * h + b);
+        T s = d < 0 ? -u : u;
+
+        Quat<T> q = (1 - u) * q1[i] + s * q2[i];
+        T l       = 1 / std::sqrt (q ^ q);
+
+        result[i] = q * l;
+    }
+}
+
 ///
 /// Spherical Cubic Spline Interpolation - from Advanced Animation and
 /// Rendering Techniques by Watt and Watt, Page 366:
@@ -813,6 +950,55 @@ Quat<T>::toMatrix44() const noexcept
                         1);
 }
 
+/// Convert `n` quaternions, given as separate arrays of their real
+/// parts `r` and imaginary components `x`, `y` and `z`, to rotation
+/// matrices.  `result[i]` is set to the matrix of quaternion `i`,
+/// as computed by Quat::toMatrix44().
+///
+/// The structure-of-arrays input lets the compiler vectorize the
+/// loop across quaternions with the default floating-point options.  `result` may not alias the inputs.
+template <class T>
+inline void
+quatToMatrix44 (const T* IMATH_RESTRICT r,
+                const T* IMATH_RESTRICT x,
+                const T* IMATH_RESTRICT y,
+                const T* IMATH_RESTRICT z,
+                size_t n,
+                Matrix44<T>* IMATH_RESTRICT result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        T* m = result[i].getValue();
+
+        m[0]  = 1 - 2 * (y[i] * y[i] + z[i] * z[i]);
+        m[1]  = 2 * (x[i] * y[i] + z[i] * r[i]);
+        m[2]  = 2 * (z[i] * x[i] - y[i] * r[i]);
+        m[3]  = 0;
+        m[4]  = 2 * (x[i] * y[i] - z[i] * r[i]);
+        m[5]  = 1 - 2 * (z[i] * z[i] + x[i] * x[i]);
+        m[6]  = 2 * (y[i] * z[i] + x[i] * r[i]);
+        m[7]  = 0;
+        m[8]  = 2 * (z[i] * x[i] + y[i] * r[i]);
+        m[9]  = 2 * (y[i] * z[i] - x[i] * r[i]);
+        m[10] = 1 - 2 * (y[i] * y[i] + x[i] * x[i]);
+        m[11] = 0;
+        m[12] = 0;
+        m[13] = 0;
+        m[14] = 0;
+        m[15] = 1;
+    }
+}
+
+/// Convert the `n` quaternions `q` to rotation matrices, setting
+/// `result[i]` to `q[i].toMatrix44()`.
+template <class T>
+inline void
+quatToMatrix44 (const Quat<T>* q, size_t n, Matrix44<T>* result) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+        result[i] = q[i].toMatrix44();
+}
+
 /// Transform the quaternion by the matrix
 /// @return M * q
 template <class T>
@@ -0,0 +1,291 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// A spherical cubic spline through a sequence of quaternion keys
+//
+
+#ifndef INCLUDED_IMATHQUATSPLINE_H
+#define INCLUDED_IMATHQUATSPLINE_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathQuat.h"
+
+#include <algorithm>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The QuatSpline class represents a rotation curve through a
+/// sequence of quaternion keys.  Between keys `i` and `i+1` it
+/// evaluates to the same rotation as
+///
+///     spline (key[i-1], key[i], key[i+1], key[i+2], t)
+///
+/// with the first and last keys repeated at the ends of the curve.
+///
+/// spline() computes the inner quadrangle points with intermediate(),
+/// which costs a log() and exp() per neighbour, on every call.
+/// QuatSpline computes them once per segment, when the keys are set,
+/// along with the angles of the two fixed slerps of squad(), so each
+/// evaluation performs a single slerp with a varying angle.
+///
+/// As with spline(), the tangents assume uniformly spaced keys; key
+/// times only control where each segment starts and ends.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE QuatSpline
+{
+  public:
+
+    /// @{
+    /// @name Constructors
+
+    /// An empty curve, which evaluates to the identity
+    QuatSpline() noexcept;
+
+    /// Construct from `n` keys, key `i` being at time `i`.
+    QuatSpline (const Quat<T>* keys, size_t n);
+
+    /// Construct from `n` keys, key `i` being at time `times[i]`.
+    /// The times must be strictly increasing.
+    QuatSpline (const Quat<T>* keys, const T* times, size_t n);
+
+    /// @}
+
+    /// @{
+    /// @name Keys
+
+    /// Set `n` keys, key `i` being at time `i`.
+    void setKeys (const Quat<T>* keys, size_t n);
+
+    /// Set `n` keys, key `i` being at time `times[i]`.  The times must
+    /// be strictly increasing.
+    void setKeys (const Quat<T>* keys, const T* times, size_t n);
+
+    /// Return the number of keys
+    size_t numKeys() const noexcept;
+
+    /// Return the time of the first key
+    T startTime() const noexcept;
+
+    /// Return the time of the last key
+    T endTime() const noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Evaluation
+
+    /// Return the rotation at the given time.  Times before the
+    /// first key or after the last are clamped.
+    Quat<T> evaluate (T time) const noexcept;
+
+    /// Evaluate the curve at the `n` times `times[i]`, storing the
+    /// results in `result[i]`.  The times may be in any order, but
+    /// runs of times within the same segment are located only once.
+    void evaluate (const T* times, size_t n, Quat<T>* result) const noexcept;
+
+    /// @}
+
+  private:
+
+    //
+    // The quadrangle of one segment, and the angle and reciprocal
+    // sinc of the angle for the slerps from q1 to q2 and from qa to qb.
+    //
+
+    struct Segment
+    {
+        Quat<T> q1, qa, qb, q2;
+        T a12, k12;
+        T aab, kab;
+    };
+
+    size_t findSegment (T time) const noexcept;
+    Quat<T> evaluateSegment (size_t i, T time) const noexcept;
+
+    std::vector<T> _times;
+    std::vector<Segment> _segments;
+    Quat<T> _single;
+};
+
+/// QuatSpline of type float
+typedef QuatSpline<float> QuatSplinef;
+
+/// QuatSpline of type double
+typedef QuatSpline<double> QuatSplined;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T> inline QuatSpline<T>::QuatSpline() noexcept : _single()
+{
+    // empty
+}
+
+template <class T> inline QuatSpline<T>::QuatSpline (const Quat<T>* keys, size_t n)
+{
+    setKeys (keys, n);
+}
+
+template <class T>
+inline QuatSpline<T>::QuatSpline (const Quat<T>* keys, const T* times, size_t n)
+{
+    setKeys (keys, times, n);
+}
+
+template <class T>
+void
+QuatSpline<T>::setKeys (const Quat<T>* keys, size_t n)
+{
+    std::vector<T> times (n);
+
+    for (size_t i = 0; i < n; ++i)
+        times[i] = T (i);
+
+    setKeys (keys, n ? &times[0] : nullptr, n);
+}
+
+template <class T>
+void
+QuatSpline<T>::setKeys (const Quat<T>* keys, const T* times, size_t n)
+{
+    _times.assign (times, times + n);
+    _segments.clear();
+    _single = n ? keys[0] : Quat<T>();
+
+    if (n < 2)
+        return;
+
+    _segments.resize (n - 1);
+
+    for (size_t i = 0; i + 1 < n; ++i)
+    {
+        const Quat<T>& q0 = keys[i > 0 ? i - 1 : 0];
+        const Quat<T>& q1 = keys[i];
+        const Quat<T>& q2 = keys[i + 1];
+        const Quat<T>& q3 = keys[i + 2 < n ? i + 2 : n - 1];
+
+        Segment& s = _segments[i];
+
+        s.q1 = q1;
+        s.q2 = q2;
+        s.qa = intermediate (q0, q1, q2);
+        s.qb = intermediate (q1, q2, q3);
+
+        s.a12 = angle4D (s.q1, s.q2);
+        s.k12 = 1 / sinx_over_x (s.a12);
+        s.aab = angle4D (s.qa, s.qb);
+        s.kab = 1 / sinx_over_x (s.aab);
+    }
+}
+
+template <class T>
+inline size_t
+QuatSpline<T>::numKeys() const noexcept
+{
+    return _times.size();
+}
+
+template <class T>
+inline T
+QuatSpline<T>::startTime() const noexcept
+{
+    return _times.empty() ? T (0) : _times.front();
+}
+
+template <class T>
+inline T
+QuatSpline<T>::endTime() const noexcept
+{
+    return _times.empty() ? T (0) : _times.back();
+}
+
+template <class T>
+inline size_t
+QuatSpline<T>::findSegment (T time) const noexcept
+{
+    //
+    // The last segment whose start time is not after `time`,
+    // clamped to the valid range.
+    //
+
+    size_t i = std::upper_bound (_times.begin(), _times.end(), time) - _times.begin();
+    return std::min (i > 0 ? i - 1 : 0, _segments.size() - 1);
+}
+
+template <class T>
+inline Quat<T>
+QuatSpline<T>::evaluateSegment (size_t i, T time) const noexcept
+{
+    const Segment& s = _segments[i];
+
+    T t = (time - _times[i]) / (_times[i + 1] - _times[i]);
+    t   = std::min (std::max (t, T (0)), T (1));
+    T u = 1 - t;
+
+    //
+    // squad (q1, qa, qb, q2, t), using the cached angles for the
+    // first two slerps.
+    //
+
+    T w1 = sinx_over_x (u * s.a12) * s.k12 * u;
+    T w2 = sinx_over_x (t * s.a12) * s.k12 * t;
+    Quat<T> r1 = (w1 * s.q1 + w2 * s.q2).normalized();
+
+    T wa = sinx_over_x (u * s.aab) * s.kab * u;
+    T wb = sinx_over_x (t * s.aab) * s.kab * t;
+    Quat<T> r2 = (wa * s.qa + wb * s.qb).normalized();
+
+    return slerp (r1, r2, 2 * t * u);
+}
+
+template <class T>
+Quat<T>
+QuatSpline<T>::evaluate (T time) const noexcept
+{
+    if (_segments.empty())
+        return _single;
+
+    return evaluateSegment (findSegment (time), time);
+}
+
+template <class T>
+void
+QuatSpline<T>::evaluate (const T* times, size_t n, Quat<T>* result) const noexcept
+{
+    if (_segments.empty())
+    {
+        std::fill (result, result + n, _single);
+        return;
+    }
+
+    size_t last = _segments.size() - 1;
+    size_t seg  = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T time = times[i];
+
+        //
+        // Sample times are usually coherent, so only search when the
+        // time leaves the current segment.
+        //
+
+        if ((seg > 0 && time < _times[seg]) || (seg < last && time >= _times[seg + 1]))
+            seg = findSegment (time);
+
+        result[i] = evaluateSegment (seg, time);
+    }
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHQUATSPLINE_H
@@ -4,7 +4,7 @@
 //
 
 //
-// Functions to solve linear, quadratic or cubic equations
+// Functions to solve linear, quadratic, cubic or quartic equations
 //
 // Note: It is possible that an equation has real solutions, but that
 // the solutions (or some intermediate result) are not representable.
@@ -18,7 +18,9 @@
 
 #include "ImathMath.h"
 #include "ImathNamespace.h"
+#include "ImathPlatform.h"
 #include <complex>
+#include <cstddef>
 
 /// @cond Doxygen_Suppress
 
@@ -79,6 +81,100 @@ IMATH_HOSTDEVICE IMATH_CONSTEXPR14 int solveNormalizedCubic (T r, T s, T t, T x[
 /// numbers are solutions, otherwise return the number of solutions.
 template <class T> IMATH_HOSTDEVICE IMATH_CONSTEXPR14 int solveCubic (T a, T b, T c, T d, T x[3]);
 
+///
+/// Solve for x in the quartic equation:
+///
+///   a * x*x*x*x + b * x*x*x + c * x*x + d * x + e == 0
+///
+/// The equation is solved with Ferrari's method: the largest real
+/// solution of a resolvent cubic, found with solveNormalizedCubic(),
+/// factors the quartic into two quadratics. Each solution is then
+/// refined with Newton's method, on the original equation. A
+/// multiple solution may be returned more than once.
+///
+/// @return 0 if there is no solution, and -1 if all real
+/// numbers are solutions, otherwise return the number of solutions.
+template <class T>
+IMATH_HOSTDEVICE IMATH_CONSTEXPR14 int solveQuartic (T a, T b, T c, T d, T e, T x[4]);
+
+///
+/// Solve the `n` quadratic equations
+///
+///   a[i] * x*x + b[i] * x + c[i] == 0
+///
+/// whose coefficients are stored in separate arrays. `numRoots[i]`
+/// is set to what `solveQuadratic()` returns for equation `i`, and
+/// `x0[i]` and `x1[i]` to its solutions, which are the same as those
+/// of `solveQuadratic()`; solutions beyond the number of solutions
+/// are unspecified.
+///
+/// All cases are computed for every equation and the results are
+/// selected rather than branched on. The work is split into passes
+/// over blocks of equations, which vectorize with the default
+/// floating-point options except for the pass that takes the
+/// square roots.
+template <class T>
+void solveQuadratic (const T* IMATH_RESTRICT a,
+                     const T* IMATH_RESTRICT b,
+                     const T* IMATH_RESTRICT c,
+                     size_t n,
+                     T* IMATH_RESTRICT x0,
+                     T* IMATH_RESTRICT x1,
+                     int* IMATH_RESTRICT numRoots) noexcept;
+
+///
+/// Solve the `n` cubic equations
+///
+///   a[i] * x*x*x + b[i] * x*x + c[i] * x + d[i] == 0
+///
+/// whose coefficients are stored in separate arrays. `numRoots[i]`
+/// is set to what `solveCubic()` returns for equation `i`, and
+/// `x0[i]`, `x1[i]` and `x2[i]` to its solutions; solutions beyond
+/// the number of solutions are unspecified.
+///
+/// The equations are solved with real arithmetic only: the single
+/// real solution with real cube roots, and three real solutions
+/// with the trigonometric form of Cardano's Formula. The cases are
+/// told apart with masks rather than branches, in passes as for
+/// the batched `solveQuadratic()`; the cube roots and trigonometric
+/// functions are evaluated only for the equations that need them.
+template <class T>
+void solveCubic (const T* IMATH_RESTRICT a,
+                 const T* IMATH_RESTRICT b,
+                 const T* IMATH_RESTRICT c,
+                 const T* IMATH_RESTRICT d,
+                 size_t n,
+                 T* IMATH_RESTRICT x0,
+                 T* IMATH_RESTRICT x1,
+                 T* IMATH_RESTRICT x2,
+                 int* IMATH_RESTRICT numRoots) noexcept;
+
+///
+/// Solve the `n` quartic equations
+///
+///   a[i] * x*x*x*x + b[i] * x*x*x + c[i] * x*x + d[i] * x + e[i] == 0
+///
+/// whose coefficients are stored in separate arrays. `numRoots[i]`
+/// is set to the number of solutions of equation `i`, as returned by
+/// `solveQuartic()`, and `x0[i]` to `x3[i]` to the solutions;
+/// solutions beyond the number of solutions are unspecified.
+///
+/// The equations are solved as by `solveQuartic()`, in blocks, with
+/// the passes of the batched `solveCubic()` for the resolvent cubics
+/// and of the batched `solveQuadratic()` for the factors.
+template <class T>
+void solveQuartic (const T* IMATH_RESTRICT a,
+                   const T* IMATH_RESTRICT b,
+                   const T* IMATH_RESTRICT c,
+                   const T* IMATH_RESTRICT d,
+                   const T* IMATH_RESTRICT e,
+                   size_t n,
+                   T* IMATH_RESTRICT x0,
+                   T* IMATH_RESTRICT x1,
+                   T* IMATH_RESTRICT x2,
+                   T* IMATH_RESTRICT x3,
+                   int* IMATH_RESTRICT numRoots) noexcept;
+
 //---------------
 // Implementation
 //---------------
@@ -153,6 +249,22 @@ solveNormalizedCubic (T r, T s, T t, T x[3])
         return 1;
     }
 
+    if (D > 0)
+    {
+        //
+        // A single real solution. The principal complex cube root
+        // of a negative number is not real, so use real cube roots
+        // instead, taking the sign of the square root that avoids
+        // cancellation.
+        //
+
+        T w = q2 > 0 ? -q2 - std::sqrt (D) : -q2 + std::sqrt (D);
+        T u = std::cbrt (w);
+
+        x[0] = u - p3 / u - r / 3;
+        return 1;
+    }
+
     COMPLEX_NAMESPACE::complex<T> u = COMPLEX_NAMESPACE::pow (
         -q / 2 + COMPLEX_NAMESPACE::sqrt (COMPLEX_NAMESPACE::complex<T> (D)),
         T (1) / T (3));
@@ -169,12 +281,7 @@ solveNormalizedCubic (T r, T s, T t, T x[3])
     COMPLEX_NAMESPACE::complex<T> y2 (-(u + v) / T (2) -
                                       (u - v) / T (2) * COMPLEX_NAMESPACE::complex<T> (0, sqrt3));
 
-    if (D > 0)
-    {
-        x[0] = y0.real() - r / 3;
-        return 1;
-    }
-    else if (D == 0)
+    if (D == 0)
     {
         x[0] = y0.real() - r / 3;
         x[1] = y1.real() - r / 3;
@@ -203,6 +310,564 @@ solveCubic (T a, T b, T c, T d, T x[3])
     }
 }
 
+/// @cond Doxygen_Suppress
+
+//
+// Refine a solution x of the normalized quartic equation
+// x*x*x*x + A * x*x*x + B * x*x + C * x + D == 0 with two steps of
+// Newton's method, each of which is kept only if it reduces the
+// residual. Near multiple solutions, where the derivative vanishes,
+// the steps are unreliable.
+//
+
+template <class T>
+IMATH_HOSTDEVICE inline T
+polishQuarticRoot (T A, T B, T C, T D, T x) noexcept
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        T f  = (((x + A) * x + B) * x + C) * x + D;
+        T df = ((4 * x + 3 * A) * x + 2 * B) * x + C;
+        T y  = x - f / (df != 0 ? df : T (1));
+        T g  = (((y + A) * y + B) * y + C) * y + D;
+        x    = std::abs (g) < std::abs (f) ? y : x;
+    }
+
+    return x;
+}
+
+/// @endcond
+
+template <class T>
+IMATH_CONSTEXPR14 int
+solveQuartic (T a, T b, T c, T d, T e, T x[4])
+{
+    if (a == 0)
+        return solveCubic (b, c, d, e, x);
+
+    T A = b / a;
+    T B = c / a;
+    T C = d / a;
+    T D = e / a;
+
+    //
+    // Substituting x = y - A / 4 gives the depressed quartic
+    //
+    //   y*y*y*y + p * y*y + q * y + r == 0
+    //
+
+    T A2 = A * A;
+    T p  = B - 3 * A2 / 8;
+    T q  = C - A * B / 2 + A2 * A / 8;
+    T r  = D - A * C / 4 + A2 * B / 16 - 3 * A2 * A2 / 256;
+
+    //
+    // For a solution m of the resolvent cubic, the quartic is
+    //
+    //   (y*y + m)^2 - (v * y - sign(q) * u)^2 == 0
+    //
+    // with u*u == m*m - r and v*v == 2 * m - p, which are positive
+    // for the largest solution, and it factors into two quadratics.
+    //
+
+    T z[3];
+    int nz = solveNormalizedCubic (-p / 2, -r, p * r / 2 - q * q / 8, z);
+    T m    = z[0];
+
+    for (int i = 1; i < nz; ++i)
+        if (z[i] > m)
+            m = z[i];
+
+    T u2 = m * m - r;
+    T v2 = 2 * m - p;
+    T u  = u2 > 0 ? std::sqrt (u2) : T (0);
+    T v  = v2 > 0 ? std::sqrt (v2) : T (0);
+
+    if (q < 0)
+        v = -v;
+
+    int n = solveQuadratic (T (1), v, m - u, x);
+
+    //
+    // If u and v are both zero, the quadratics are the same.
+    //
+
+    if (u != 0 || v != 0)
+        n += solveQuadratic (T (1), -v, m + u, x + n);
+
+    for (int i = 0; i < n; ++i)
+        x[i] = polishQuarticRoot (A, B, C, D, x[i] - A / 4);
+
+    return n;
+}
+
+/// @cond Doxygen_Suppress
+
+//
+// The batched solvers work on blocks of at most 64 equations, in
+// passes over arrays on the stack. A pass either computes values
+// and stores them, or selects between values that are already
+// stored: with the default -ftrapping-math, compilers won't
+// vectorize a loop in which arithmetic is needed by only one side
+// of a select, and they turn a division by a selected divisor into
+// divisions on each side. The square roots have a loop of their
+// own, which vectorizes only without -fmath-errno, but keeps the
+// other passes free of calls.
+//
+// quadraticRoots() solves a block of quadratic equations. The
+// numbers of solutions are stored as T, which vectorizes with the
+// coefficients where masks converted to int may not; the batched
+// solvers convert them in a separate loop.
+//
+
+template <class T>
+inline void
+quadraticRoots (const T* IMATH_RESTRICT a,
+                const T* IMATH_RESTRICT b,
+                const T* IMATH_RESTRICT c,
+                size_t n,
+                T* IMATH_RESTRICT x0,
+                T* IMATH_RESTRICT x1,
+                T* IMATH_RESTRICT count) noexcept
+{
+    T disc[64], root[64], num[64], den[64], div[64];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T D     = b[i] * b[i] - 4 * a[i] * c[i];
+        disc[i] = D;
+        root[i] = D > 0 ? D : T (0);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+        root[i] = std::sqrt (root[i]);
+
+    //
+    // Where D == 0, the square root is zero, and q / a is the
+    // -b / (2 * a) of solveQuadratic().
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T A = a[i], B = b[i], C = c[i], D = disc[i];
+        T q = -(B + (B > 0 ? T (1) : T (-1)) * root[i]) / T (2);
+
+        bool linear = A == 0;
+        bool two    = D > 0;
+
+        num[i] = linear ? -C : q;
+        den[i] = linear ? (B != 0 ? B : T (1)) : A;
+        div[i] = two ? q : T (1);
+
+        T nq = two ? T (2) : T (0);
+        nq   = D == 0 ? T (1) : nq;
+        T nl = C != 0 ? T (0) : T (-1);
+        nl   = B != 0 ? T (1) : nl;
+
+        count[i] = linear ? nl : nq;
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x0[i] = num[i] / den[i];
+        x1[i] = c[i] / div[i];
+    }
+}
+
+//
+// cubicRoots() solves a block of cubic equations. The cube roots
+// and the trigonometric functions are computed only for the
+// equations that need them, which are gathered without branches
+// into index lists.
+//
+
+template <class T>
+inline void
+cubicRoots (const T* IMATH_RESTRICT a,
+            const T* IMATH_RESTRICT b,
+            const T* IMATH_RESTRICT c,
+            const T* IMATH_RESTRICT d,
+            size_t n,
+            T* IMATH_RESTRICT x0,
+            T* IMATH_RESTRICT x1,
+            T* IMATH_RESTRICT x2,
+            T* IMATH_RESTRICT count) noexcept
+{
+    const T sqrt3 = T (1.73205080756887729352744634150587);
+
+    T shift[64], p3[64], q2[64], w[64], m[64], ca[64], kind[64];
+    T y0[64], y1[64], y2[64], z0[64], z1[64], nq[64];
+    int oneIndex[64], threeIndex[64];
+
+    //
+    // The solutions where a[i] == 0
+    //
+
+    quadraticRoots (b, c, d, n, z0, z1, nq);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        bool cubic = a[i] != 0;
+        T ia       = cubic ? a[i] : T (1);
+
+        T r = b[i] / ia;
+        T s = c[i] / ia;
+        T t = d[i] / ia;
+        T p = (3 * s - r * r) / 3;
+        T q = 2 * r * r * r / 27 - r * s / 3 + t;
+        T Q = q / 2;
+        T P = p / 3;
+        T D = P * P * P + Q * Q;
+
+        bool triple = D == 0 && P == 0;
+        bool one    = D > 0;
+
+        T nc = one ? T (1) : T (3);
+        nc   = D == 0 ? T (2) : nc;
+        nc   = triple ? T (1) : nc;
+
+        T kd = one ? T (1) : T (3);
+        kd   = triple ? T (0) : kd;
+
+        count[i] = cubic ? nc : nq[i];
+        kind[i]  = cubic ? kd : T (0);
+        shift[i] = r / 3;
+        p3[i]    = P;
+        q2[i]    = Q;
+        w[i]     = one ? D : T (0);
+        m[i]     = P < 0 ? -P : T (0);
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        w[i] = std::sqrt (w[i]);
+        m[i] = std::sqrt (m[i]);
+    }
+
+    //
+    // A single real solution, u - p3 / u, from the real cube root u
+    // of w, as in solveNormalizedCubic(); three real solutions,
+    // 2 m cos ((phi + 2 pi k) / 3), where D <= 0 implies p3 <= 0,
+    // with cos (phi) clamped to [-1, 1]; and a triple solution.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T M   = m[i];
+        T m3  = M * M * M;
+        w[i]  = -(q2[i] + (q2[i] > 0 ? T (1) : T (-1)) * w[i]);
+        ca[i] = m3 != 0 ? m3 : T (1);
+        y0[i] = -shift[i];
+        y1[i] = -shift[i];
+        y2[i] = -shift[i];
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T C   = -q2[i] / ca[i];
+        C     = C < T (-1) ? T (-1) : C;
+        ca[i] = C > T (1) ? T (1) : C;
+    }
+
+    int numOne = 0, numThree = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        oneIndex[numOne]     = int (i);
+        threeIndex[numThree] = int (i);
+
+        numOne += kind[i] == T (1);
+        numThree += kind[i] == T (3);
+    }
+
+    for (int l = 0; l < numOne; ++l)
+    {
+        int i = oneIndex[l];
+        T u   = std::cbrt (w[i]);
+        y0[i] = u - p3[i] / u - shift[i];
+    }
+
+    for (int l = 0; l < numThree; ++l)
+    {
+        int i = threeIndex[l];
+        T phi = std::acos (ca[i]) / 3;
+        T cp  = m[i] * std::cos (phi);
+        T sp  = m[i] * sqrt3 * std::sin (phi);
+        y0[i] = 2 * cp - shift[i];
+        y1[i] = -cp - sp - shift[i];
+        y2[i] = sp - cp - shift[i];
+    }
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        bool cubic = a[i] != 0;
+        x0[i]      = cubic ? y0[i] : z0[i];
+        x1[i]      = cubic ? y1[i] : z1[i];
+        x2[i]      = y2[i];
+    }
+}
+
+/// @endcond
+
+template <class T>
+void
+solveQuadratic (const T* IMATH_RESTRICT a,
+                const T* IMATH_RESTRICT b,
+                const T* IMATH_RESTRICT c,
+                size_t n,
+                T* IMATH_RESTRICT x0,
+                T* IMATH_RESTRICT x1,
+                int* IMATH_RESTRICT numRoots) noexcept
+{
+    T count[64];
+
+    for (size_t i0 = 0; i0 < n; i0 += 64)
+    {
+        size_t k = n - i0 < 64 ? n - i0 : 64;
+
+        quadraticRoots (a + i0, b + i0, c + i0, k, x0 + i0, x1 + i0, count);
+
+        for (size_t i = 0; i < k; ++i)
+            numRoots[i0 + i] = int (count[i]);
+    }
+}
+
+template <class T>
+void
+solveCubic (const T* IMATH_RESTRICT a,
+            const T* IMATH_RESTRICT b,
+            const T* IMATH_RESTRICT c,
+            const T* IMATH_RESTRICT d,
+            size_t n,
+            T* IMATH_RESTRICT x0,
+            T* IMATH_RESTRICT x1,
+            T* IMATH_RESTRICT x2,
+            int* IMATH_RESTRICT numRoots) noexcept
+{
+    T count[64];
+
+    for (size_t i0 = 0; i0 < n; i0 += 64)
+    {
+        size_t k = n - i0 < 64 ? n - i0 : 64;
+
+        cubicRoots (a + i0, b + i0, c + i0, d + i0, k, x0 + i0, x1 + i0, x2 + i0, count);
+
+        for (size_t i = 0; i < k; ++i)
+            numRoots[i0 + i] = int (count[i]);
+    }
+}
+
+/// @cond Doxygen_Suppress
+
+//
+// polishQuarticRoot() for a block of solutions x[i] of the
+// normalized quartic equations with coefficients A[i] to D[i], in
+// passes as in cubicRoots().
+//
+
+template <class T>
+inline void
+polishQuarticRoots (const T* IMATH_RESTRICT A,
+                    const T* IMATH_RESTRICT B,
+                    const T* IMATH_RESTRICT C,
+                    const T* IMATH_RESTRICT D,
+                    size_t n,
+                    T* IMATH_RESTRICT x) noexcept
+{
+    T f[64], df[64];
+
+    for (int k = 0; k < 2; ++k)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            T X   = x[i];
+            T F   = (((X + A[i]) * X + B[i]) * X + C[i]) * X + D[i];
+            T dF  = ((4 * X + 3 * A[i]) * X + 2 * B[i]) * X + C[i];
+            f[i]  = F;
+            df[i] = dF != 0 ? dF : T (1);
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T X  = x[i];
+            T Y  = X - f[i] / df[i];
+            T G  = (((Y + A[i]) * Y + B[i]) * Y + C[i]) * Y + D[i];
+            x[i] = std::abs (G) < std::abs (f[i]) ? Y : X;
+        }
+    }
+}
+
+/// @endcond
+
+template <class T>
+void
+solveQuartic (const T* IMATH_RESTRICT a,
+              const T* IMATH_RESTRICT b,
+              const T* IMATH_RESTRICT c,
+              const T* IMATH_RESTRICT d,
+              const T* IMATH_RESTRICT e,
+              size_t n,
+              T* IMATH_RESTRICT x0,
+              T* IMATH_RESTRICT x1,
+              T* IMATH_RESTRICT x2,
+              T* IMATH_RESTRICT x3,
+              int* IMATH_RESTRICT numRoots) noexcept
+{
+    //
+    // The equations are solved in blocks of 64. The first passes set
+    // up a cubic equation for each quartic one: its resolvent cubic,
+    // or, where a[i] == 0, the cubic that the equation reduces to.
+    // The cubics are solved together, and the remaining passes factor
+    // the quartics into two quadratics each, as solveQuartic() does.
+    //
+
+    T A[64], B[64], C[64], D[64], p[64], q[64], r[64], rb[64], rc[64], rd[64];
+    T b0[64], c0[64], d0[64], e0[64];
+    T ca[64], cb[64], cc[64], cd[64], y0[64], y1[64], y2[64], nz[64];
+    T one[64], m[64], u[64], v[64], b1[64], c1[64], b2[64], c2[64];
+    T z0[64], z1[64], z2[64], z3[64], n1[64], n2[64], w0[64], w1[64], w2[64], w3[64];
+
+    for (size_t i = 0; i < 64; ++i)
+        one[i] = 1;
+
+    for (size_t i0 = 0; i0 < n; i0 += 64)
+    {
+        size_t k = n - i0 < 64 ? n - i0 : 64;
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            size_t j = i0 + i;
+            T ia     = a[j] != 0 ? a[j] : T (1);
+
+            T Ai = b[j] / ia;
+            T Bi = c[j] / ia;
+            T Ci = d[j] / ia;
+            T Di = e[j] / ia;
+            T A2 = Ai * Ai;
+            T pi = Bi - 3 * A2 / 8;
+            T qi = Ci - Ai * Bi / 2 + A2 * Ai / 8;
+            T ri = Di - Ai * Ci / 4 + A2 * Bi / 16 - 3 * A2 * A2 / 256;
+
+            A[i]  = Ai;
+            B[i]  = Bi;
+            C[i]  = Ci;
+            D[i]  = Di;
+            p[i]  = pi;
+            q[i]  = qi;
+            r[i]  = ri;
+            rb[i] = -pi / 2;
+            rc[i] = -ri;
+            rd[i] = pi * ri / 2 - qi * qi / 8;
+            b0[i] = b[j];
+            c0[i] = c[j];
+            d0[i] = d[j];
+            e0[i] = e[j];
+        }
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            bool quartic = a[i0 + i] != 0;
+
+            ca[i] = quartic ? T (1) : b0[i];
+            cb[i] = quartic ? rb[i] : c0[i];
+            cc[i] = quartic ? rc[i] : d0[i];
+            cd[i] = quartic ? rd[i] : e0[i];
+        }
+
+        cubicRoots (ca, cb, cc, cd, k, y0, y1, y2, nz);
+
+        //
+        // The largest solution m of the resolvent cubic, and the
+        // squares of u and v
+        //
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            T M  = y0[i];
+            T m1 = y1[i] > M ? y1[i] : M;
+            M    = nz[i] > 1 ? m1 : M;
+            T m2 = y2[i] > M ? y2[i] : M;
+            m[i] = nz[i] > 2 ? m2 : M;
+        }
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            T u2 = m[i] * m[i] - r[i];
+            T v2 = 2 * m[i] - p[i];
+            u[i] = u2 > 0 ? u2 : T (0);
+            v[i] = v2 > 0 ? v2 : T (0);
+        }
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            u[i] = std::sqrt (u[i]);
+            v[i] = std::sqrt (v[i]);
+        }
+
+        //
+        // The quadratics y*y + v * y + m - u and y*y - v * y + m + u
+        //
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            T V   = q[i] < 0 ? -v[i] : v[i];
+            b1[i] = V;
+            c1[i] = m[i] - u[i];
+            b2[i] = -V;
+            c2[i] = m[i] + u[i];
+        }
+
+        quadraticRoots (one, b1, c1, k, z0, z1, n1);
+        quadraticRoots (one, b2, c2, k, z2, z3, n2);
+
+        //
+        // If u and v are both zero, the quadratics are the same. Pack
+        // the solutions of the two quadratics.
+        //
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            T N1  = n1[i];
+            T nv  = v[i] != 0 ? n2[i] : T (0);
+            T N2  = u[i] != 0 ? n2[i] : nv;
+            T W1  = N1 > 1 ? z1[i] : z2[i];
+            w0[i] = N1 > 0 ? z0[i] : z2[i];
+            w1[i] = N1 > 0 ? W1 : z3[i];
+            w2[i] = N1 > 1 ? z2[i] : z3[i];
+            n2[i] = N1 + N2;
+        }
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            T shift = A[i] / 4;
+            w0[i] -= shift;
+            w1[i] -= shift;
+            w2[i] -= shift;
+            w3[i] = z3[i] - shift;
+        }
+
+        polishQuarticRoots (A, B, C, D, k, w0);
+        polishQuarticRoots (A, B, C, D, k, w1);
+        polishQuarticRoots (A, B, C, D, k, w2);
+        polishQuarticRoots (A, B, C, D, k, w3);
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            size_t j     = i0 + i;
+            bool quartic = a[j] != 0;
+
+            x0[j] = quartic ? w0[i] : y0[i];
+            x1[j] = quartic ? w1[i] : y1[i];
+            x2[j] = quartic ? w2[i] : y2[i];
+            x3[j] = w3[i];
+            n1[i] = quartic ? n2[i] : nz[i];
+        }
+
+        for (size_t i = 0; i < k; ++i)
+            numRoots[i0 + i] = int (n1[i]);
+    }
+}
+
 IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
 
 #endif // INCLUDED_IMATHROOTS_H
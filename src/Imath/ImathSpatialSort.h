@@ -0,0 +1,610 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Morton and Hilbert codes of points in a box, and a radix sort of
+// the codes, for ordering geometry by its position in space
+//
+
+#ifndef INCLUDED_IMATHSPATIALSORT_H
+#define INCLUDED_IMATHSPATIALSORT_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+#include "ImathPlatform.h"
+
+#include "ImathBox.h"
+#include "ImathVec.h"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//
+// With BMI2, the bits of the coordinates are interleaved with the
+// pdep and pext instructions. Note that on AMD processors before
+// Zen 3 these instructions are microcoded and slower than the
+// portable shift-and-mask code.
+//
+
+#if defined(__BMI2__) && (defined(__x86_64__) || defined(_M_X64)) && !defined(__CUDA_ARCH__)
+#    include <immintrin.h>
+#    define IMATH_MORTON_BMI2
+#endif
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+/// @{
+/// @name Morton Codes
+///
+/// The Morton code, or Z-order index, of a point with integer
+/// coordinates interleaves the bits of the coordinates, with bit `k`
+/// of `x` at bit `2k` (2D) or `3k` (3D) of the code. Points with
+/// nearby codes are nearby in space.
+///
+/// 2D codes take the low 16 bits of each coordinate, and 3D codes
+/// the low 21 bits; the higher bits are ignored.
+
+/// Return the 2D Morton code of `(x, y)`.
+IMATH_HOSTDEVICE inline uint32_t
+mortonEncode (uint32_t x, uint32_t y) noexcept
+{
+#ifdef IMATH_MORTON_BMI2
+    return _pdep_u32 (x, 0x55555555u) | _pdep_u32 (y, 0xaaaaaaaau);
+#else
+    uint32_t c[2] = { x, y };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        uint32_t v = c[i] & 0x0000ffffu;
+        v          = (v | (v << 8)) & 0x00ff00ffu;
+        v          = (v | (v << 4)) & 0x0f0f0f0fu;
+        v          = (v | (v << 2)) & 0x33333333u;
+        v          = (v | (v << 1)) & 0x55555555u;
+        c[i]       = v;
+    }
+
+    return c[0] | (c[1] << 1);
+#endif
+}
+
+/// Return the 3D Morton code of `(x, y, z)`.
+IMATH_HOSTDEVICE inline uint64_t
+mortonEncode (uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+#ifdef IMATH_MORTON_BMI2
+    return _pdep_u64 (x, 0x1249249249249249ull) | _pdep_u64 (y, 0x2492492492492492ull) |
+           _pdep_u64 (z, 0x4924924924924924ull);
+#else
+    uint64_t c[3] = { x, y, z };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        uint64_t v = c[i] & 0x1fffffull;
+        v          = (v | (v << 32)) & 0x001f00000000ffffull;
+        v          = (v | (v << 16)) & 0x001f0000ff0000ffull;
+        v          = (v | (v << 8)) & 0x100f00f00f00f00full;
+        v          = (v | (v << 4)) & 0x10c30c30c30c30c3ull;
+        v          = (v | (v << 2)) & 0x1249249249249249ull;
+        c[i]       = v;
+    }
+
+    return c[0] | (c[1] << 1) | (c[2] << 2);
+#endif
+}
+
+/// Return in `(x, y)` the coordinates of the 2D Morton code `code`.
+IMATH_HOSTDEVICE inline void
+mortonDecode (uint32_t code, uint32_t& x, uint32_t& y) noexcept
+{
+#ifdef IMATH_MORTON_BMI2
+    x = _pext_u32 (code, 0x55555555u);
+    y = _pext_u32 (code, 0xaaaaaaaau);
+#else
+    uint32_t c[2];
+
+    for (int i = 0; i < 2; ++i)
+    {
+        uint32_t v = (code >> i) & 0x55555555u;
+        v          = (v ^ (v >> 1)) & 0x33333333u;
+        v          = (v ^ (v >> 2)) & 0x0f0f0f0fu;
+        v          = (v ^ (v >> 4)) & 0x00ff00ffu;
+        v          = (v ^ (v >> 8)) & 0x0000ffffu;
+        c[i]       = v;
+    }
+
+    x = c[0];
+    y = c[1];
+#endif
+}
+
+/// Return in `(x, y, z)` the coordinates of the 3D Morton code `code`.
+IMATH_HOSTDEVICE inline void
+mortonDecode (uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) noexcept
+{
+#ifdef IMATH_MORTON_BMI2
+    x = uint32_t (_pext_u64 (code, 0x1249249249249249ull));
+    y = uint32_t (_pext_u64 (code, 0x2492492492492492ull));
+    z = uint32_t (_pext_u64 (code, 0x4924924924924924ull));
+#else
+    uint32_t c[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        uint64_t v = (code >> i) & 0x1249249249249249ull;
+        v          = (v ^ (v >> 2)) & 0x10c30c30c30c30c3ull;
+        v          = (v ^ (v >> 4)) & 0x100f00f00f00f00full;
+        v          = (v ^ (v >> 8)) & 0x001f0000ff0000ffull;
+        v          = (v ^ (v >> 16)) & 0x001f00000000ffffull;
+        v          = (v ^ (v >> 32)) & 0x1fffffull;
+        c[i]       = uint32_t (v);
+    }
+
+    x = c[0];
+    y = c[1];
+    z = c[2];
+#endif
+}
+
+/// @}
+
+/// @cond Doxygen_Suppress
+//
+// John Skilling's conversions between the coordinates of a point
+// and the "transpose" of its Hilbert index: the index with its bits
+// distributed over N integers of B bits, as the bits of a Morton
+// code are distributed over the coordinates. (Programming the
+// Hilbert curve, AIP Conference Proceedings 707, 2004.) The bit
+// tests select between inverting and exchanging bits with masks,
+// rather than branches, which are unpredictable.
+//
+
+template <int N, int B, size_t L>
+IMATH_HOSTDEVICE inline void
+hilbertAxesToTranspose (uint32_t (&x)[N][L], size_t n) noexcept
+{
+    //
+    // The points are processed in lanes, x[i][k] being coordinate i
+    // of point k, so that the loops vectorize across points.
+    //
+
+    const uint32_t m = 1u << (B - 1);
+
+    for (uint32_t q = m; q > 1; q >>= 1)
+    {
+        uint32_t p             = q - 1;
+        uint32_t* IMATH_RESTRICT x0 = x[0];
+
+        //
+        // For i == 0, the exchange is a no-op.
+        //
+
+        for (size_t k = 0; k < n; ++k)
+            x0[k] ^= p & (0u - ((x0[k] & q) != 0));
+
+        for (int i = 1; i < N; ++i)
+        {
+            uint32_t* IMATH_RESTRICT xi = x[i];
+
+            for (size_t k = 0; k < n; ++k)
+            {
+                uint32_t set = 0u - ((xi[k] & q) != 0);
+                uint32_t t   = (x0[k] ^ xi[k]) & p & ~set;
+                x0[k] ^= (p & set) | t;
+                xi[k] ^= t;
+            }
+        }
+    }
+
+    for (int i = 1; i < N; ++i)
+    {
+        for (size_t k = 0; k < n; ++k)
+            x[i][k] ^= x[i - 1][k];
+    }
+
+    for (size_t k = 0; k < n; ++k)
+    {
+        uint32_t t = 0;
+
+        for (uint32_t q = m; q > 1; q >>= 1)
+            t ^= (q - 1) & (0u - ((x[N - 1][k] & q) != 0));
+
+        for (int i = 0; i < N; ++i)
+            x[i][k] ^= t;
+    }
+}
+
+template <int N, int B>
+IMATH_HOSTDEVICE inline void
+hilbertTransposeToAxes (uint32_t (&x)[N]) noexcept
+{
+    const uint32_t n = 2u << (B - 1);
+
+    uint32_t t = x[N - 1] >> 1;
+
+    for (int i = N - 1; i > 0; --i)
+        x[i] ^= x[i - 1];
+
+    x[0] ^= t;
+
+    for (uint32_t q = 2; q != n; q <<= 1)
+    {
+        uint32_t p = q - 1;
+
+        for (int i = N - 1; i >= 0; --i)
+        {
+            uint32_t set = 0u - ((x[i] & q) != 0);
+            uint32_t s   = (x[0] ^ x[i]) & p & ~set;
+            x[0] ^= (p & set) | s;
+            x[i] ^= s;
+        }
+    }
+}
+/// @endcond
+
+/// @{
+/// @name Hilbert Codes
+///
+/// The Hilbert code of a point with integer coordinates is its index
+/// along a Hilbert curve through all the points of the grid. Points
+/// with consecutive codes are neighbors in the grid, which makes the
+/// order of Hilbert codes more coherent than the order of Morton
+/// codes, at a higher cost.
+///
+/// As with Morton codes, 2D codes take the low 16 bits of each
+/// coordinate, and 3D codes the low 21 bits.
+
+/// Return the 2D Hilbert code of `(x, y)`.
+IMATH_HOSTDEVICE inline uint32_t
+hilbertEncode (uint32_t x, uint32_t y) noexcept
+{
+    uint32_t c[2][1] = { { x & 0xffffu }, { y & 0xffffu } };
+    hilbertAxesToTranspose<2, 16> (c, 1);
+    return mortonEncode (c[1][0], c[0][0]);
+}
+
+/// Return the 3D Hilbert code of `(x, y, z)`.
+IMATH_HOSTDEVICE inline uint64_t
+hilbertEncode (uint32_t x, uint32_t y, uint32_t z) noexcept
+{
+    uint32_t c[3][1] = { { x & 0x1fffffu }, { y & 0x1fffffu }, { z & 0x1fffffu } };
+    hilbertAxesToTranspose<3, 21> (c, 1);
+    return mortonEncode (c[2][0], c[1][0], c[0][0]);
+}
+
+/// Return in `(x, y)` the coordinates of the 2D Hilbert code `code`.
+IMATH_HOSTDEVICE inline void
+hilbertDecode (uint32_t code, uint32_t& x, uint32_t& y) noexcept
+{
+    uint32_t c[2];
+    mortonDecode (code, c[1], c[0]);
+    hilbertTransposeToAxes<2, 16> (c);
+    x = c[0];
+    y = c[1];
+}
+
+/// Return in `(x, y, z)` the coordinates of the 3D Hilbert code `code`.
+IMATH_HOSTDEVICE inline void
+hilbertDecode (uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) noexcept
+{
+    uint32_t c[3];
+    mortonDecode (code, c[2], c[1], c[0]);
+    hilbertTransposeToAxes<3, 21> (c);
+    x = c[0];
+    y = c[1];
+    z = c[2];
+}
+
+/// @}
+
+/// @cond Doxygen_Suppress
+//
+// Map the points of a box onto a grid of 2^B cells per axis. Points
+// outside the box are clamped to the nearest cell, and the axes
+// along which the box is flat map to cell 0.
+//
+
+template <class V, int B> class SpatialQuantizer
+{
+  public:
+    typedef typename V::BaseType T;
+
+    explicit SpatialQuantizer (const Box<V>& bounds) noexcept
+        : _min (bounds.min), _max (T ((1u << B) - 1))
+    {
+        V s = bounds.size();
+
+        for (unsigned int i = 0; i < V::dimensions(); ++i)
+            _scale[i] = s[i] > 0 ? T (1u << B) / s[i] : T (0);
+    }
+
+    uint32_t operator() (const V& p, unsigned int i) const noexcept
+    {
+        T v = (p[i] - _min[i]) * _scale[i];
+        v   = v > 0 ? v : T (0);
+        v   = v < _max ? v : _max;
+        return uint32_t (v);
+    }
+
+  private:
+    V _min;
+    V _scale;
+    T _max;
+};
+/// @endcond
+
+/// @{
+/// @name Spatial Codes of Points and Boxes
+///
+/// The point `p` is mapped onto a grid that divides the box `bounds`
+/// into 2^16 (2D) or 2^21 (3D) cells along each axis, and the code
+/// of its cell is returned. Points outside the box are clamped to
+/// the nearest cell. The batched functions compute the codes of the
+/// `n` points `points[i]`, or of the centers of the `n` boxes
+/// `boxes[i]`, in `codes[i]`.
+///
+/// Sorting geometry by the codes of its positions, for example with
+/// `radixSort()`, puts geometry that is nearby in space nearby in
+/// memory.
+
+/// Return the 2D Morton code of `p` in `bounds`.
+template <class T>
+inline uint32_t
+mortonCode (const Vec2<T>& p, const Box<Vec2<T>>& bounds) noexcept
+{
+    SpatialQuantizer<Vec2<T>, 16> q (bounds);
+    return mortonEncode (q (p, 0), q (p, 1));
+}
+
+/// Return the 3D Morton code of `p` in `bounds`.
+template <class T>
+inline uint64_t
+mortonCode (const Vec3<T>& p, const Box<Vec3<T>>& bounds) noexcept
+{
+    SpatialQuantizer<Vec3<T>, 21> q (bounds);
+    return mortonEncode (q (p, 0), q (p, 1), q (p, 2));
+}
+
+/// Return the 2D Hilbert code of `p` in `bounds`.
+template <class T>
+inline uint32_t
+hilbertCode (const Vec2<T>& p, const Box<Vec2<T>>& bounds) noexcept
+{
+    SpatialQuantizer<Vec2<T>, 16> q (bounds);
+    return hilbertEncode (q (p, 0), q (p, 1));
+}
+
+/// Return the 3D Hilbert code of `p` in `bounds`.
+template <class T>
+inline uint64_t
+hilbertCode (const Vec3<T>& p, const Box<Vec3<T>>& bounds) noexcept
+{
+    SpatialQuantizer<Vec3<T>, 21> q (bounds);
+    return hilbertEncode (q (p, 0), q (p, 1), q (p, 2));
+}
+
+/// Compute the 2D Morton codes of the points `points[i]` in `bounds`.
+template <class T>
+void
+mortonCodes (const Vec2<T>* points, size_t n, const Box<Vec2<T>>& bounds, uint32_t* codes) noexcept
+{
+    SpatialQuantizer<Vec2<T>, 16> q (bounds);
+
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = mortonEncode (q (points[i], 0), q (points[i], 1));
+}
+
+/// Compute the 3D Morton codes of the points `points[i]` in `bounds`.
+template <class T>
+void
+mortonCodes (const Vec3<T>* points, size_t n, const Box<Vec3<T>>& bounds, uint64_t* codes) noexcept
+{
+    SpatialQuantizer<Vec3<T>, 21> q (bounds);
+
+    for (size_t i = 0; i < n; ++i)
+        codes[i] = mortonEncode (q (points[i], 0), q (points[i], 1), q (points[i], 2));
+}
+
+/// Compute the 3D Morton codes of the centers of the boxes
+/// `boxes[i]` in `bounds`.
+template <class T>
+void
+mortonCodes (const Box<Vec3<T>>* boxes, size_t n, const Box<Vec3<T>>& bounds, uint64_t* codes) noexcept
+{
+    SpatialQuantizer<Vec3<T>, 21> q (bounds);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c = (boxes[i].min + boxes[i].max) * T (0.5);
+        codes[i]  = mortonEncode (q (c, 0), q (c, 1), q (c, 2));
+    }
+}
+
+/// Compute the 2D Hilbert codes of the points `points[i]` in `bounds`.
+template <class T>
+void
+hilbertCodes (const Vec2<T>* points, size_t n, const Box<Vec2<T>>& bounds, uint32_t* codes) noexcept
+{
+    SpatialQuantizer<Vec2<T>, 16> q (bounds);
+
+    const size_t block = 64;
+    uint32_t c[2][block];
+
+    for (size_t start = 0; start < n; start += block)
+    {
+        size_t m = n - start < block ? n - start : block;
+
+        for (size_t k = 0; k < m; ++k)
+        {
+            for (int j = 0; j < 2; ++j)
+                c[j][k] = q (points[start + k], j);
+        }
+
+        hilbertAxesToTranspose<2, 16> (c, m);
+
+        for (size_t k = 0; k < m; ++k)
+            codes[start + k] = mortonEncode (c[1][k], c[0][k]);
+    }
+}
+
+/// Compute the 3D Hilbert codes of the points `points[i]` in `bounds`.
+template <class T>
+void
+hilbertCodes (const Vec3<T>* points, size_t n, const Box<Vec3<T>>& bounds, uint64_t* codes) noexcept
+{
+    SpatialQuantizer<Vec3<T>, 21> q (bounds);
+
+    const size_t block = 64;
+    uint32_t c[3][block];
+
+    for (size_t start = 0; start < n; start += block)
+    {
+        size_t m = n - start < block ? n - start : block;
+
+        for (size_t k = 0; k < m; ++k)
+        {
+            for (int j = 0; j < 3; ++j)
+                c[j][k] = q (points[start + k], j);
+        }
+
+        hilbertAxesToTranspose<3, 21> (c, m);
+
+        for (size_t k = 0; k < m; ++k)
+            codes[start + k] = mortonEncode (c[2][k], c[1][k], c[0][k]);
+    }
+}
+
+/// Compute the 3D Hilbert codes of the centers of the boxes
+/// `boxes[i]` in `bounds`.
+template <class T>
+void
+hilbertCodes (const Box<Vec3<T>>* boxes, size_t n, const Box<Vec3<T>>& bounds, uint64_t* codes) noexcept
+{
+    SpatialQuantizer<Vec3<T>, 21> q (bounds);
+
+    const size_t block = 64;
+    uint32_t c[3][block];
+
+    for (size_t start = 0; start < n; start += block)
+    {
+        size_t m = n - start < block ? n - start : block;
+
+        for (size_t k = 0; k < m; ++k)
+        {
+            const Box<Vec3<T>>& b = boxes[start + k];
+            Vec3<T> center        = (b.min + b.max) * T (0.5);
+
+            for (int j = 0; j < 3; ++j)
+                c[j][k] = q (center, j);
+        }
+
+        hilbertAxesToTranspose<3, 21> (c, m);
+
+        for (size_t k = 0; k < m; ++k)
+            codes[start + k] = mortonEncode (c[2][k], c[1][k], c[0][k]);
+    }
+}
+
+/// @}
+
+///
+/// Sort the `n` unsigned integer keys `keys[i]` into ascending
+/// order, and, unless `values` is null, apply the same permutation
+/// to the `n` values `values[i]`. The sort is stable: keys that are
+/// equal keep their order. With `values[i]` initialized to `i`, the
+/// sorted values are the order of the original array.
+///
+/// This is a least significant digit radix sort, with 11-bit digits.
+/// The digits that are the same in all the keys, such as the high
+/// bits of codes of fewer than 64 bits, are skipped. It allocates
+/// temporary arrays of `n` keys and values.
+///
+
+template <class K>
+void
+radixSort (K* keys, int* values, size_t n)
+{
+    static_assert (std::is_integral<K>::value && std::is_unsigned<K>::value,
+                   "radixSort requires unsigned integer keys");
+
+    const int digitBits = 11;
+    const int numBins   = 1 << digitBits;
+    const int numDigits = (int (sizeof (K)) * 8 + digitBits - 1) / digitBits;
+
+    if (n < 2)
+        return;
+
+    //
+    // The histograms of all the digits are counted in one pass.
+    //
+
+    std::vector<size_t> counts (numDigits * numBins, 0);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint64_t k = keys[i];
+
+        for (int d = 0; d < numDigits; ++d)
+            counts[d * numBins + ((k >> (digitBits * d)) & (numBins - 1))]++;
+    }
+
+    std::vector<K> keyBuffer (n);
+    std::vector<int> valueBuffer (values ? n : 0);
+
+    K* srcKeys     = keys;
+    K* dstKeys     = &keyBuffer[0];
+    int* srcValues = values;
+    int* dstValues = values ? &valueBuffer[0] : nullptr;
+
+    for (int d = 0; d < numDigits; ++d)
+    {
+        size_t* count = &counts[d * numBins];
+        int shift     = digitBits * d;
+
+        if (count[(uint64_t (srcKeys[0]) >> shift) & (numBins - 1)] == n)
+            continue;
+
+        size_t offset = 0;
+
+        for (int b = 0; b < numBins; ++b)
+        {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+
+        if (srcValues)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                size_t j     = count[(uint64_t (srcKeys[i]) >> shift) & (numBins - 1)]++;
+                dstKeys[j]   = srcKeys[i];
+                dstValues[j] = srcValues[i];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < n; ++i)
+                dstKeys[count[(uint64_t (srcKeys[i]) >> shift) & (numBins - 1)]++] = srcKeys[i];
+        }
+
+        std::swap (srcKeys, dstKeys);
+        std::swap (srcValues, dstValues);
+    }
+
+    if (srcKeys != keys)
+    {
+        memcpy (keys, srcKeys, n * sizeof (K));
+
+        if (values)
+            memcpy (values, srcValues, n * sizeof (int));
+    }
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHSPATIALSORT_H
@@ -15,8 +15,14 @@
 
 #include "ImathBox.h"
 #include "ImathLine.h"
+#include "ImathPlatform.h"
+#include "ImathRandom.h"
 #include "ImathVec.h"
 
+#include <cstddef>
+#include <limits>
+#include <vector>
+
 IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
 
 ///
@@ -56,6 +62,33 @@ template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Sphere3
     ///	encloses Box b.
     IMATH_HOSTDEVICE void circumscribe (const Box<Vec3<T>>& box);
 
+    ///	Set the center and radius of the sphere so that it encloses
+    ///	the `n` points `points[i]`, with Ritter's method: the sphere
+    ///	starts as the sphere whose diameter is the most distant pair
+    ///	of the points that are extreme along the axes and the
+    ///	diagonals of the unit cube, and is then grown to enclose each
+    ///	point in turn. The result is typically within a few percent
+    ///	of the minimal bounding sphere, in two passes over the
+    ///	points. If `n` is 0, the sphere is set to radius 0 at the
+    ///	origin.
+    void circumscribe (const Vec3<T>* points, size_t n) noexcept;
+
+    ///	Set the center and radius of the sphere to the smallest
+    ///	sphere that encloses the `n` points `points[i]`, with Welzl's
+    ///	algorithm, up to rounding. The points are visited in a
+    ///	pseudo-random order, which takes expected linear time, but is
+    ///	several times slower than `circumscribe()`. If `n` is 0, the
+    ///	sphere is set to radius 0 at the origin.
+    void circumscribeMinimal (const Vec3<T>* points, size_t n);
+
+    ///	Grow the sphere, if necessary, so that it encloses the point
+    ///	`p`, keeping the side of the sphere opposite `p` in place.
+    void extendBy (const Vec3<T>& p) noexcept;
+
+    ///	Grow the sphere, if necessary, to the smallest sphere that
+    ///	encloses both itself and the sphere `s`.
+    void extendBy (const Sphere3<T>& s) noexcept;
+
     /// @}
     
     /// @{
@@ -101,6 +134,328 @@ Sphere3<T>::circumscribe (const Box<Vec3<T>>& box)
     radius = (box.max - center).length();
 }
 
+template <class T>
+inline void
+Sphere3<T>::extendBy (const Vec3<T>& p) noexcept
+{
+    T d2 = (p - center).length2();
+
+    if (d2 > radius * radius)
+    {
+        T d = std::sqrt (d2);
+        T r = (radius + d) * T (0.5);
+        center += (p - center) * ((r - radius) / d);
+        radius = r;
+    }
+}
+
+template <class T>
+inline void
+Sphere3<T>::extendBy (const Sphere3<T>& s) noexcept
+{
+    T d = (s.center - center).length();
+
+    if (d + s.radius <= radius)
+        return;
+
+    if (d + radius <= s.radius)
+    {
+        *this = s;
+        return;
+    }
+
+    T r = (d + radius + s.radius) * T (0.5);
+    center += (s.center - center) * ((r - radius) / d);
+    radius = r;
+}
+
+/// @cond Doxygen_Suppress
+//
+// Find the indices of the points with the smallest and largest
+// projections onto the three axes and the four diagonals of the unit
+// cube, for Ritter's method. The diagonals need not be normalized,
+// since only the points, and not the projections, are compared across
+// directions.
+//
+
+template <class T>
+void
+extremePoints (const Vec3<T>* points, size_t n, T lo[8], T hi[8], size_t loIndex[8], size_t hiIndex[8]) noexcept
+{
+    //
+    // The directions are padded to eight by repeating the x axis.
+    // The extreme projections of each chunk of points are found with
+    // the projections of groups of points as one flat array of lanes,
+    // as in boundsOf(), which vectorizes. Only if the chunk improves
+    // on the extremes so far, which soon becomes rare for points in no
+    // particular order, is it searched again for their indices.
+    //
+
+    const size_t dirs  = 8;
+    const size_t group = 8;
+    const size_t lanes = group * dirs;
+    const size_t chunk = 64;
+
+    for (size_t k = 0; k < dirs; ++k)
+    {
+        lo[k]      = std::numeric_limits<T>::infinity();
+        hi[k]      = -std::numeric_limits<T>::infinity();
+        loIndex[k] = 0;
+        hiIndex[k] = 0;
+    }
+
+    for (size_t start = 0; start < n; start += chunk)
+    {
+        size_t m = n - start < chunk ? n - start : chunk;
+
+        T chunkLo[lanes], chunkHi[lanes], proj[lanes];
+
+        for (size_t k = 0; k < lanes; ++k)
+        {
+            chunkLo[k] = std::numeric_limits<T>::infinity();
+            chunkHi[k] = -std::numeric_limits<T>::infinity();
+        }
+
+        for (size_t i = 0; i < m; i += group)
+        {
+            size_t g = m - i < group ? m - i : group;
+
+            for (size_t j = 0; j < group; ++j)
+            {
+                const Vec3<T> p = points[start + i + (j < g ? j : 0)];
+
+                T s = p.x + p.y;
+                T d = p.x - p.y;
+
+                T* q = proj + j * dirs;
+                q[0] = p.x;
+                q[1] = p.y;
+                q[2] = p.z;
+                q[3] = s + p.z;
+                q[4] = s - p.z;
+                q[5] = d + p.z;
+                q[6] = d - p.z;
+                q[7] = p.x;
+            }
+
+            for (size_t k = 0; k < lanes; ++k)
+            {
+                chunkLo[k] = proj[k] < chunkLo[k] ? proj[k] : chunkLo[k];
+                chunkHi[k] = proj[k] > chunkHi[k] ? proj[k] : chunkHi[k];
+            }
+        }
+
+        int improved = 0;
+
+        for (size_t k = 0; k < lanes; ++k)
+            improved |= (chunkLo[k] < lo[k % dirs]) | (chunkHi[k] > hi[k % dirs]);
+
+        if (!improved)
+            continue;
+
+        for (size_t i = start; i < start + m; ++i)
+        {
+            const Vec3<T> p = points[i];
+
+            T s = p.x + p.y;
+            T d = p.x - p.y;
+
+            T q[dirs] = { p.x, p.y, p.z, s + p.z, s - p.z, d + p.z, d - p.z, p.x };
+
+            for (size_t k = 0; k < dirs; ++k)
+            {
+                if (q[k] < lo[k])
+                {
+                    lo[k]      = q[k];
+                    loIndex[k] = i;
+                }
+
+                if (q[k] > hi[k])
+                {
+                    hi[k]      = q[k];
+                    hiIndex[k] = i;
+                }
+            }
+        }
+    }
+}
+
+/// @endcond
+
+template <class T>
+void
+Sphere3<T>::circumscribe (const Vec3<T>* points, size_t n) noexcept
+{
+    if (n == 0)
+    {
+        *this = Sphere3<T>();
+        return;
+    }
+
+    const int numDirections = 7;
+
+    T lo[8], hi[8];
+    size_t loIndex[8], hiIndex[8];
+
+    extremePoints (points, n, lo, hi, loIndex, hiIndex);
+
+    //
+    // Start with the most distant pair of extreme points as the
+    // diameter, then grow the sphere to enclose all the points.
+    //
+
+    Vec3<T> a   = points[loIndex[0]];
+    Vec3<T> b   = points[hiIndex[0]];
+    T maxLength = (b - a).length2();
+
+    for (int k = 1; k < numDirections; ++k)
+    {
+        T length = (points[hiIndex[k]] - points[loIndex[k]]).length2();
+
+        if (length > maxLength)
+        {
+            a         = points[loIndex[k]];
+            b         = points[hiIndex[k]];
+            maxLength = length;
+        }
+    }
+
+    center = (a + b) * T (0.5);
+    radius = std::sqrt (maxLength) * T (0.5);
+
+    for (size_t i = 0; i < n; ++i)
+        extendBy (points[i]);
+}
+
+/// @cond Doxygen_Suppress
+//
+// The smallest spheres with two, three and four points on their
+// surface, for Welzl's algorithm. Three collinear or four coplanar
+// points have no such sphere, and are instead enclosed by a sphere
+// through fewer of them.
+//
+
+template <class T>
+inline Sphere3<T>
+sphereThrough (const Vec3<T>& a, const Vec3<T>& b) noexcept
+{
+    return Sphere3<T> ((a + b) * T (0.5), (b - a).length() * T (0.5));
+}
+
+template <class T>
+inline Sphere3<T>
+sphereThrough (const Vec3<T>& a, const Vec3<T>& b, const Vec3<T>& c) noexcept
+{
+    Vec3<T> u = b - a;
+    Vec3<T> v = c - a;
+    Vec3<T> w = u % v;
+    T d       = 2 * w.length2();
+
+    if (d <= std::numeric_limits<T>::epsilon() * u.length2() * v.length2())
+    {
+        Sphere3<T> s = sphereThrough (a, b);
+        s.extendBy (sphereThrough (a, c));
+        s.extendBy (sphereThrough (b, c));
+        return s;
+    }
+
+    Vec3<T> offset = (w % u * v.length2() + v % w * u.length2()) / d;
+    return Sphere3<T> (a + offset, offset.length());
+}
+
+template <class T>
+inline Sphere3<T>
+sphereThrough (const Vec3<T>& a, const Vec3<T>& b, const Vec3<T>& c, const Vec3<T>& e) noexcept
+{
+    Vec3<T> u = b - a;
+    Vec3<T> v = c - a;
+    Vec3<T> w = e - a;
+    T d       = 2 * (u ^ (v % w));
+
+    if (std::abs (d) <= std::numeric_limits<T>::epsilon() * u.length() * v.length() * w.length())
+    {
+        Sphere3<T> s = sphereThrough (a, b, c);
+        s.extendBy (e);
+        return s;
+    }
+
+    Vec3<T> offset = ((v % w) * u.length2() + (w % u) * v.length2() + (u % v) * w.length2()) / d;
+    return Sphere3<T> (a + offset, offset.length());
+}
+
+template <class T>
+inline bool
+outsideSphere (const Sphere3<T>& s, const Vec3<T>& p) noexcept
+{
+    //
+    // Points on the sphere, up to rounding, are inside; otherwise
+    // rounding errors would make the algorithm restart needlessly.
+    //
+
+    T r = s.radius * (1 + 16 * std::numeric_limits<T>::epsilon());
+    return (p - s.center).length2() > r * r;
+}
+
+/// @endcond
+
+template <class T>
+void
+Sphere3<T>::circumscribeMinimal (const Vec3<T>* points, size_t n)
+{
+    if (n == 0)
+    {
+        *this = Sphere3<T>();
+        return;
+    }
+
+    //
+    // The iterative form of Welzl's algorithm: whenever a point is
+    // outside the sphere of the points before it, the sphere is
+    // rebuilt with that point on its surface. The expected running
+    // time is linear only if the points are visited in random order.
+    //
+
+    std::vector<Vec3<T>> p (points, points + n);
+    Rand32 rand (n);
+
+    for (size_t i = n - 1; i > 0; --i)
+        std::swap (p[i], p[rand.nexti() % (i + 1)]);
+
+    Sphere3<T> s (p[0], 0);
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        if (!outsideSphere (s, p[i]))
+            continue;
+
+        s = Sphere3<T> (p[i], 0);
+
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (!outsideSphere (s, p[j]))
+                continue;
+
+            s = sphereThrough (p[i], p[j]);
+
+            for (size_t k = 0; k < j; ++k)
+            {
+                if (!outsideSphere (s, p[k]))
+                    continue;
+
+                s = sphereThrough (p[i], p[j], p[k]);
+
+                for (size_t l = 0; l < k; ++l)
+                {
+                    if (outsideSphere (s, p[l]))
+                        s = sphereThrough (p[i], p[j], p[k], p[l]);
+                }
+            }
+        }
+    }
+
+    *this = s;
+}
+
 template <class T>
 IMATH_CONSTEXPR14 bool
 Sphere3<T>::intersectT (const Line3<T>& line, T& t) const
@@ -0,0 +1,666 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+//
+// Arrays of 3D vectors in structure-of-arrays form
+//
+
+#ifndef INCLUDED_IMATHVECARRAY_H
+#define INCLUDED_IMATHVECARRAY_H
+
+#include "ImathExport.h"
+#include "ImathNamespace.h"
+
+#include "ImathVec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+IMATH_INTERNAL_NAMESPACE_HEADER_ENTER
+
+///
+/// The Vec3Array class holds an array of 3D vectors in
+/// structure-of-arrays form: the x, y and z components are stored in
+/// three separate arrays, each aligned to a 64-byte boundary. The
+/// element-wise operations below are written as simple loops over
+/// these arrays, which compilers vectorize.
+///
+/// The arrays can be accessed directly with x(), y() and z(), and
+/// converted to and from ordinary arrays of Vec3 with assign() and
+/// copyTo(), or with the free functions aosToSoa() and soaToAos().
+///
+/// The arithmetic operations that take a second Vec3Array assume
+/// that it is the same size as this one.
+///
+
+template <class T> class IMATH_EXPORT_TEMPLATE_TYPE Vec3Array
+{
+  public:
+
+    /// @{
+    /// @name Constructors and Assignment
+
+    /// An empty array
+    Vec3Array() noexcept;
+
+    /// An array of `n` zero vectors
+    explicit Vec3Array (size_t n);
+
+    /// Construct from the `n` vectors `v[i]`
+    Vec3Array (const Vec3<T>* v, size_t n);
+
+    /// Copy constructor
+    Vec3Array (const Vec3Array& v);
+
+    /// Move constructor
+    Vec3Array (Vec3Array&& v) noexcept;
+
+    /// Assignment
+    Vec3Array& operator= (const Vec3Array& v);
+
+    /// Move assignment
+    Vec3Array& operator= (Vec3Array&& v) noexcept;
+
+    /// Destructor
+    ~Vec3Array() = default;
+
+    /// @}
+
+    /// @{
+    /// @name Size and Element Access
+
+    /// Return the number of vectors
+    size_t size() const noexcept;
+
+    /// Change the number of vectors. Existing vectors are preserved,
+    /// up to the new size; new vectors are zero.
+    void resize (size_t n);
+
+    /// Return the array of x components
+    T* x() noexcept;
+
+    /// Return the array of y components
+    T* y() noexcept;
+
+    /// Return the array of z components
+    T* z() noexcept;
+
+    /// Return the array of x components
+    const T* x() const noexcept;
+
+    /// Return the array of y components
+    const T* y() const noexcept;
+
+    /// Return the array of z components
+    const T* z() const noexcept;
+
+    /// Return vector `i`
+    Vec3<T> operator[] (size_t i) const noexcept;
+
+    /// Set vector `i`
+    void set (size_t i, const Vec3<T>& v) noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Conversion to and from Arrays of Vec3
+
+    /// Replace the contents with the `n` vectors `v[i]`
+    void assign (const Vec3<T>* v, size_t n);
+
+    /// Copy the vectors to `v[0] ... v[size()-1]`
+    void copyTo (Vec3<T>* v) const noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Arithmetic
+
+    /// Component-wise addition
+    const Vec3Array& operator+= (const Vec3Array& v) noexcept;
+
+    /// Component-wise subtraction
+    const Vec3Array& operator-= (const Vec3Array& v) noexcept;
+
+    /// Component-wise multiplication
+    const Vec3Array& operator*= (const Vec3Array& v) noexcept;
+
+    /// Component-wise multiplication by a scalar
+    const Vec3Array& operator*= (T a) noexcept;
+
+    /// Component-wise division by a scalar
+    const Vec3Array& operator/= (T a) noexcept;
+
+    /// @}
+
+    /// @{
+    /// @name Query and Manipulation
+
+    /// Store the dot products of the vectors with those of `v` in
+    /// `result[i]`.
+    void dot (const Vec3Array& v, T* result) const noexcept;
+
+    /// Store the cross products of the vectors with those of `v` in
+    /// `result`, which is resized to match. `result` may be either of
+    /// the arguments.
+    void cross (const Vec3Array& v, Vec3Array& result) const;
+
+    /// Store the lengths of the vectors in `result[i]`. The results
+    /// are the same as those of Vec3<T>::length(), including for
+    /// vectors whose squared length underflows.
+    void length (T* result) const noexcept;
+
+    /// Store the squared lengths of the vectors in `result[i]`.
+    void length2 (T* result) const noexcept;
+
+    /// Normalize the vectors in place, as Vec3<T>::normalize() does:
+    /// null vectors are left unchanged.
+    const Vec3Array& normalize() noexcept;
+
+    /// @}
+
+  private:
+
+    //
+    // The three component arrays are stored one after the other in
+    // _storage, starting _offset elements in, so that each of them
+    // is aligned to _alignment bytes, with _stride elements between
+    // the start of consecutive arrays.
+    //
+
+    static const size_t _alignment = 64;
+
+    void allocate (size_t n);
+
+    std::vector<T> _storage;
+    size_t _size;
+    size_t _stride;
+    size_t _offset;
+};
+
+/// Vec3Array of type float
+typedef Vec3Array<float> V3fArray;
+
+/// Vec3Array of type double
+typedef Vec3Array<double> V3dArray;
+
+/// Transpose the `n` vectors `v[i]` to the component arrays `x`, `y`
+/// and `z`.
+template <class T>
+void aosToSoa (const Vec3<T>* v, size_t n, T* x, T* y, T* z) noexcept;
+
+/// Transpose the component arrays `x`, `y` and `z` to the `n` vectors
+/// `v[i]`.
+template <class T>
+void soaToAos (const T* x, const T* y, const T* z, size_t n, Vec3<T>* v) noexcept;
+
+//---------------
+// Implementation
+//---------------
+
+template <class T>
+void
+aosToSoa (const Vec3<T>* IMATH_RESTRICT v,
+          size_t n,
+          T* IMATH_RESTRICT x,
+          T* IMATH_RESTRICT y,
+          T* IMATH_RESTRICT z) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = v[i].x;
+        y[i] = v[i].y;
+        z[i] = v[i].z;
+    }
+}
+
+template <class T>
+void
+soaToAos (const T* IMATH_RESTRICT x,
+          const T* IMATH_RESTRICT y,
+          const T* IMATH_RESTRICT z,
+          size_t n,
+          Vec3<T>* IMATH_RESTRICT v) noexcept
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        v[i].x = x[i];
+        v[i].y = y[i];
+        v[i].z = z[i];
+    }
+}
+
+template <class T>
+inline Vec3Array<T>::Vec3Array() noexcept : _size (0), _stride (0), _offset (0)
+{
+    // empty
+}
+
+template <class T> inline Vec3Array<T>::Vec3Array (size_t n) : _size (0), _stride (0), _offset (0)
+{
+    allocate (n);
+}
+
+template <class T>
+inline Vec3Array<T>::Vec3Array (const Vec3<T>* v, size_t n)
+    : _size (0), _stride (0), _offset (0)
+{
+    assign (v, n);
+}
+
+template <class T>
+inline Vec3Array<T>::Vec3Array (const Vec3Array& v) : _size (0), _stride (0), _offset (0)
+{
+    *this = v;
+}
+
+template <class T>
+inline Vec3Array<T>::Vec3Array (Vec3Array&& v) noexcept
+    : _storage (std::move (v._storage)),
+      _size (v._size),
+      _stride (v._stride),
+      _offset (v._offset)
+{
+    v._size   = 0;
+    v._stride = 0;
+    v._offset = 0;
+}
+
+template <class T>
+inline Vec3Array<T>&
+Vec3Array<T>::operator= (const Vec3Array& v)
+{
+    if (this != &v)
+    {
+        //
+        // The copied storage may be aligned differently, so the
+        // components are copied array by array.
+        //
+
+        allocate (v._size);
+
+        std::copy (v.x(), v.x() + _size, x());
+        std::copy (v.y(), v.y() + _size, y());
+        std::copy (v.z(), v.z() + _size, z());
+    }
+
+    return *this;
+}
+
+template <class T>
+inline Vec3Array<T>&
+Vec3Array<T>::operator= (Vec3Array&& v) noexcept
+{
+    _storage  = std::move (v._storage);
+    _size     = v._size;
+    _stride   = v._stride;
+    _offset   = v._offset;
+    v._size   = 0;
+    v._stride = 0;
+    v._offset = 0;
+    return *this;
+}
+
+template <class T>
+void
+Vec3Array<T>::allocate (size_t n)
+{
+    //
+    // Round the stride up to a whole number of alignment blocks, and
+    // leave room to move the start of the arrays to the next
+    // alignment boundary.
+    //
+
+    const size_t block = _alignment / sizeof (T);
+
+    _size   = n;
+    _stride = (n + block - 1) / block * block;
+
+    std::vector<T> (3 * _stride + block).swap (_storage);
+
+    uintptr_t address = reinterpret_cast<uintptr_t> (_storage.data());
+    _offset           = (_alignment - address % _alignment) % _alignment / sizeof (T);
+}
+
+template <class T>
+inline size_t
+Vec3Array<T>::size() const noexcept
+{
+    return _size;
+}
+
+template <class T>
+void
+Vec3Array<T>::resize (size_t n)
+{
+    if (n == _size)
+        return;
+
+    Vec3Array<T> v (n);
+    size_t m = n < _size ? n : _size;
+
+    std::copy (x(), x() + m, v.x());
+    std::copy (y(), y() + m, v.y());
+    std::copy (z(), z() + m, v.z());
+
+    *this = std::move (v);
+}
+
+template <class T>
+inline T*
+Vec3Array<T>::x() noexcept
+{
+    return _storage.data() + _offset;
+}
+
+template <class T>
+inline T*
+Vec3Array<T>::y() noexcept
+{
+    return _storage.data() + _offset + _stride;
+}
+
+template <class T>
+inline T*
+Vec3Array<T>::z() noexcept
+{
+    return _storage.data() + _offset + 2 * _stride;
+}
+
+template <class T>
+inline const T*
+Vec3Array<T>::x() const noexcept
+{
+    return _storage.data() + _offset;
+}
+
+template <class T>
+inline const T*
+Vec3Array<T>::y() const noexcept
+{
+    return _storage.data() + _offset + _stride;
+}
+
+template <class T>
+inline const T*
+Vec3Array<T>::z() const noexcept
+{
+    return _storage.data() + _offset + 2 * _stride;
+}
+
+template <class T>
+inline Vec3<T>
+Vec3Array<T>::operator[] (size_t i) const noexcept
+{
+    return Vec3<T> (x()[i], y()[i], z()[i]);
+}
+
+template <class T>
+inline void
+Vec3Array<T>::set (size_t i, const Vec3<T>& v) noexcept
+{
+    x()[i] = v.x;
+    y()[i] = v.y;
+    z()[i] = v.z;
+}
+
+template <class T>
+void
+Vec3Array<T>::assign (const Vec3<T>* v, size_t n)
+{
+    allocate (n);
+    aosToSoa (v, n, x(), y(), z());
+}
+
+template <class T>
+void
+Vec3Array<T>::copyTo (Vec3<T>* v) const noexcept
+{
+    soaToAos (x(), y(), z(), _size, v);
+}
+
+template <class T>
+const Vec3Array<T>&
+Vec3Array<T>::operator+= (const Vec3Array& v) noexcept
+{
+    T* IMATH_RESTRICT ax       = x();
+    T* IMATH_RESTRICT ay       = y();
+    T* IMATH_RESTRICT az       = z();
+    const T* IMATH_RESTRICT bx = v.x();
+    const T* IMATH_RESTRICT by = v.y();
+    const T* IMATH_RESTRICT bz = v.z();
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        ax[i] += bx[i];
+        ay[i] += by[i];
+        az[i] += bz[i];
+    }
+
+    return *this;
+}
+
+template <class T>
+const Vec3Array<T>&
+Vec3Array<T>::operator-= (const Vec3Array& v) noexcept
+{
+    T* IMATH_RESTRICT ax       = x();
+    T* IMATH_RESTRICT ay       = y();
+    T* IMATH_RESTRICT az       = z();
+    const T* IMATH_RESTRICT bx = v.x();
+    const T* IMATH_RESTRICT by = v.y();
+    const T* IMATH_RESTRICT bz = v.z();
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        ax[i] -= bx[i];
+        ay[i] -= by[i];
+        az[i] -= bz[i];
+    }
+
+    return *this;
+}
+
+template <class T>
+const Vec3Array<T>&
+Vec3Array<T>::operator*= (const Vec3Array& v) noexcept
+{
+    T* IMATH_RESTRICT ax       = x();
+    T* IMATH_RESTRICT ay       = y();
+    T* IMATH_RESTRICT az       = z();
+    const T* IMATH_RESTRICT bx = v.x();
+    const T* IMATH_RESTRICT by = v.y();
+    const T* IMATH_RESTRICT bz = v.z();
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        ax[i] *= bx[i];
+        ay[i] *= by[i];
+        az[i] *= bz[i];
+    }
+
+    return *this;
+}
+
+template <class T>
+const Vec3Array<T>&
+Vec3Array<T>::operator*= (T a) noexcept
+{
+    T* IMATH_RESTRICT ax = x();
+    T* IMATH_RESTRICT ay = y();
+    T* IMATH_RESTRICT az = z();
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        ax[i] *= a;
+        ay[i] *= a;
+        az[i] *= a;
+    }
+
+    return *this;
+}
+
+template <class T>
+const Vec3Array<T>&
+Vec3Array<T>::operator/= (T a) noexcept
+{
+    T* IMATH_RESTRICT ax = x();
+    T* IMATH_RESTRICT ay = y();
+    T* IMATH_RESTRICT az = z();
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        ax[i] /= a;
+        ay[i] /= a;
+        az[i] /= a;
+    }
+
+    return *this;
+}
+
+template <class T>
+void
+Vec3Array<T>::dot (const Vec3Array& v, T* result) const noexcept
+{
+    const T* IMATH_RESTRICT ax = x();
+    const T* IMATH_RESTRICT ay = y();
+    const T* IMATH_RESTRICT az = z();
+    const T* IMATH_RESTRICT bx = v.x();
+    const T* IMATH_RESTRICT by = v.y();
+    const T* IMATH_RESTRICT bz = v.z();
+    T* IMATH_RESTRICT r        = result;
+
+    for (size_t i = 0; i < _size; ++i)
+        r[i] = ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i];
+}
+
+template <class T>
+void
+Vec3Array<T>::cross (const Vec3Array& v, Vec3Array& result) const
+{
+    if (&result == this || &result == &v)
+    {
+        Vec3Array<T> tmp;
+        cross (v, tmp);
+        result = std::move (tmp);
+        return;
+    }
+
+    if (result._size != _size)
+        result.allocate (_size);
+
+    const T* IMATH_RESTRICT ax = x();
+    const T* IMATH_RESTRICT ay = y();
+    const T* IMATH_RESTRICT az = z();
+    const T* IMATH_RESTRICT bx = v.x();
+    const T* IMATH_RESTRICT by = v.y();
+    const T* IMATH_RESTRICT bz = v.z();
+    T* IMATH_RESTRICT rx       = result.x();
+    T* IMATH_RESTRICT ry       = result.y();
+    T* IMATH_RESTRICT rz       = result.z();
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        rx[i] = ay[i] * bz[i] - az[i] * by[i];
+        ry[i] = az[i] * bx[i] - ax[i] * bz[i];
+        rz[i] = ax[i] * by[i] - ay[i] * bx[i];
+    }
+}
+
+template <class T>
+void
+Vec3Array<T>::length2 (T* result) const noexcept
+{
+    const T* IMATH_RESTRICT ax = x();
+    const T* IMATH_RESTRICT ay = y();
+    const T* IMATH_RESTRICT az = z();
+    T* IMATH_RESTRICT r        = result;
+
+    for (size_t i = 0; i < _size; ++i)
+        r[i] = ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i];
+}
+
+template <class T>
+void
+Vec3Array<T>::length (T* result) const noexcept
+{
+    const T* IMATH_RESTRICT ax = x();
+    const T* IMATH_RESTRICT ay = y();
+    const T* IMATH_RESTRICT az = z();
+    T* IMATH_RESTRICT r        = result;
+    const T tiny               = T (2) * std::numeric_limits<T>::min();
+    int anyTiny                = 0;
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        T l2 = ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i];
+        anyTiny |= l2 < tiny;
+        r[i] = std::sqrt (l2);
+    }
+
+    //
+    // Vectors whose squared length underflows are rare; they are
+    // redone one at a time, with the rescaling in Vec3<T>::length().
+    //
+
+    if (IMATH_UNLIKELY(anyTiny))
+    {
+        for (size_t i = 0; i < _size; ++i)
+        {
+            if (ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i] < tiny)
+                r[i] = (*this)[i].length();
+        }
+    }
+}
+
+template <class T>
+const Vec3Array<T>&
+Vec3Array<T>::normalize() noexcept
+{
+    T* IMATH_RESTRICT ax = x();
+    T* IMATH_RESTRICT ay = y();
+    T* IMATH_RESTRICT az = z();
+    const T tiny         = T (2) * std::numeric_limits<T>::min();
+    int anyTiny          = 0;
+
+    for (size_t i = 0; i < _size; ++i)
+    {
+        //
+        // Vectors whose squared length underflows are divided by 1
+        // here, and normalized one at a time below. As in
+        // Vec3<T>::normalize(), the components are divided by the
+        // length rather than multiplied by its reciprocal.
+        //
+
+        T l2     = ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i];
+        bool t   = l2 < tiny;
+        T l      = std::sqrt (t ? T (1) : l2);
+        anyTiny |= t;
+        ax[i] /= l;
+        ay[i] /= l;
+        az[i] /= l;
+    }
+
+    if (IMATH_UNLIKELY(anyTiny))
+    {
+        for (size_t i = 0; i < _size; ++i)
+        {
+            if (ax[i] * ax[i] + ay[i] * ay[i] + az[i] * az[i] < tiny)
+            {
+                Vec3<T> v = (*this)[i];
+                set (i, v.normalize());
+            }
+        }
+    }
+
+    return *this;
+}
+
+IMATH_INTERNAL_NAMESPACE_HEADER_EXIT
+
+#endif // INCLUDED_IMATHVECARRAY_H
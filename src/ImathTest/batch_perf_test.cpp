@@ -0,0 +1,1316 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+// Timings of the batched (array) functions against looping over the
+// corresponding scalar functions.
+//
+
+#include <ImathBVH.h>
+#include <ImathBoxAlgo.h>
+#include <ImathColorAlgo.h>
+#include <ImathEuler.h>
+#include <ImathFrustumTest.h>
+#include <ImathLineAlgo.h>
+#include <ImathMatrixAlgo.h>
+#include <ImathPlane.h>
+#include <ImathQuat.h>
+#include <ImathRandom.h>
+#include <ImathRoots.h>
+#include <ImathSpatialSort.h>
+#include <ImathSphere.h>
+#include <ImathVecAlgo.h>
+#include <ImathVecArray.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _MSC_VER
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <vector>
+
+using namespace IMATH_NAMESPACE;
+
+int64_t
+get_ticks (void)
+{
+#ifdef _MSC_VER
+    static uint64_t scale = 0;
+    if (scale == 0)
+    {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency (&freq);
+        scale = (1000000000 / freq.QuadPart);
+    }
+
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter (&ticks);
+    return ticks.QuadPart * scale;
+#else
+    struct timespec t;
+    uint64_t nsecs;
+
+    static uint64_t start = 0;
+    if (start == 0)
+    {
+        clock_gettime (CLOCK_MONOTONIC, &t);
+        start = t.tv_sec;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &t);
+    nsecs = (t.tv_sec - start) * 1000000000;
+    nsecs += t.tv_nsec;
+    return nsecs;
+#endif
+}
+
+void
+report (const char* name, int64_t onanos, int64_t nnanos, size_t numentries)
+{
+    fprintf (stderr,
+             "%-24s Old: %10lld (%g ns) New: %10lld (%g ns) (%10lld)\n",
+             name,
+             (long long) onanos,
+             (double) onanos / ((double) numentries),
+             (long long) nnanos,
+             (double) nnanos / ((double) numentries),
+             ((long long) (onanos - nnanos)));
+}
+
+void
+perf_test_quat_conversions (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<M44f> mats (numentries);
+    std::vector<Quatf> quats (numentries);
+    std::vector<float> r (numentries), x (numentries), y (numentries), z (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        Quatf q;
+        q.setAxisAngle (hollowSphereRand<V3f> (rand), rand.nextf (-M_PI, M_PI));
+        mats[i] = q.toMatrix44();
+    }
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        quats[i] = extractQuat (mats[i]);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    extractQuat (&mats[0], numentries, &r[0], &x[0], &y[0], &z[0]);
+    int64_t et = get_ticks();
+
+    report ("M44f -> Quatf (SoA)", oet - ost, et - st, numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        mats[i] = quats[i].toMatrix44();
+    oet = get_ticks();
+
+    st = get_ticks();
+    quatToMatrix44 (&r[0], &x[0], &y[0], &z[0], numentries, &mats[0]);
+    et = get_ticks();
+
+    report ("Quatf (SoA) -> M44f", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_euler_conversions (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<Eulerf> eulers (numentries);
+    std::vector<V3f> angles (numentries);
+    std::vector<M44f> mats (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        angles[i] = V3f (rand.nextf (-M_PI, M_PI), rand.nextf (-M_PI, M_PI), rand.nextf (-M_PI, M_PI));
+        eulers[i] = Eulerf (angles[i], Eulerf::ZXY);
+    }
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        mats[i] = eulers[i].toMatrix44();
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    eulerToMatrix44<Eulerf::ZXY> (&angles[0], numentries, &mats[0]);
+    int64_t et = get_ticks();
+
+    report ("Eulerf -> M44f", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_euler_unwrap (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    const size_t numCurves  = 64;
+    const size_t numSamples = numentries / numCurves;
+    const size_t n          = numCurves * numSamples;
+
+    std::vector<Eulerf> eulers (n);
+    std::vector<float> x (n), y (n), z (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        eulers[i] = Eulerf (V3f (rand.nextf (-M_PI, M_PI), rand.nextf (-M_PI, M_PI), rand.nextf (-M_PI, M_PI)),
+                            Eulerf::XYZ);
+        x[i]      = eulers[i].x;
+        y[i]      = eulers[i].y;
+        z[i]      = eulers[i].z;
+    }
+
+    //
+    // The scalar loop unwraps curve-major samples; the batched form
+    // takes the samples sample-major.
+    //
+
+    int64_t ost = get_ticks();
+    for (size_t c = 0; c < numCurves; ++c)
+        unwrapEulerCurve (&eulers[c * numSamples], numSamples);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    unwrapEulerCurves (Eulerf::XYZ, &x[0], &y[0], &z[0], numCurves, numSamples, numCurves);
+    int64_t et = get_ticks();
+
+    report ("Eulerf unwrap", oet - ost, et - st, n);
+}
+
+void
+perf_test_vec_array (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<V3f> v (numentries);
+    std::vector<float> result (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+        v[i] = V3f (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+    V3fArray a (&v[0], numentries);
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        result[i] = v[i].length();
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    a.length (&result[0]);
+    int64_t et = get_ticks();
+
+    report ("V3f length", oet - ost, et - st, numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        v[i].normalize();
+    oet = get_ticks();
+
+    st = get_ticks();
+    a.normalize();
+    et = get_ticks();
+
+    report ("V3f normalize", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_bounds (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<V3f> points (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+        points[i] = V3f (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+    Box3f oldBox, newBox;
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldBox.extendBy (points[i]);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    newBox = boundsOf (&points[0], numentries);
+    int64_t et = get_ticks();
+
+    if (newBox != oldBox)
+        fprintf (stderr, "boundsOf mismatch\n");
+
+    report ("Box3f bounds", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_bvh (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<Box3f> boxes (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f p (rand.nextf (-100, 100), rand.nextf (-100, 100), rand.nextf (-100, 100));
+        boxes[i] = Box3f (p, p + V3f (rand.nextf (0, 1), rand.nextf (0, 1), rand.nextf (0, 1)));
+    }
+
+    //
+    // Building is timed against computing the bounds of the boxes;
+    // the queries against testing every box, for a fixed number of
+    // queries.
+    //
+
+    Box3f bounds;
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        bounds.extendBy (boxes[i]);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    BVHf bvh (&boxes[0], numentries);
+    int64_t et = get_ticks();
+
+    if (bvh.bounds() != bounds)
+        fprintf (stderr, "BVHf bounds mismatch\n");
+
+    report ("BVHf build", oet - ost, et - st, numentries);
+
+    const size_t numQueries = 100;
+
+    std::vector<Line3f> rays (numQueries);
+    std::vector<int> found;
+    size_t oldHits = 0, newHits = 0;
+
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+        V3f p (rand.nextf (-100, 100), rand.nextf (-100, 100), rand.nextf (-100, 100));
+        rays[q] = Line3f (p, p + hollowSphereRand<V3f> (rand));
+    }
+
+    ost = get_ticks();
+    for (size_t q = 0; q < numQueries; ++q)
+        for (size_t i = 0; i < numentries; ++i)
+            oldHits += intersects (boxes[i], rays[q]);
+    oet = get_ticks();
+
+    st = get_ticks();
+    for (size_t q = 0; q < numQueries; ++q)
+        newHits += bvh.findIntersecting (rays[q], found);
+    et = get_ticks();
+
+    if (newHits != oldHits)
+        fprintf (stderr, "BVHf ray query mismatch\n");
+
+    report ("BVHf ray query", oet - ost, et - st, numQueries);
+
+    oldHits = newHits = 0;
+    found.clear();
+
+    ost = get_ticks();
+    for (size_t q = 0; q < numQueries; ++q)
+        for (size_t i = 0; i < numentries; ++i)
+            oldHits += boxes[i].intersects (rays[q].pos);
+    oet = get_ticks();
+
+    st = get_ticks();
+    for (size_t q = 0; q < numQueries; ++q)
+        newHits += bvh.findContaining (rays[q].pos, found);
+    et = get_ticks();
+
+    if (newHits != oldHits)
+        fprintf (stderr, "BVHf point query mismatch\n");
+
+    report ("BVHf point query", oet - ost, et - st, numQueries);
+}
+
+void
+perf_test_ray_packets (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<Box3f> boxes (numentries);
+    std::vector<Line3f> rays (numentries);
+    std::vector<float> px (numentries), py (numentries), pz (numentries);
+    std::vector<float> ix (numentries), iy (numentries), iz (numentries), t (numentries);
+    std::unique_ptr<bool[]> hits (new bool[numentries]);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f p (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        rays[i] = Line3f (p, p + hollowSphereRand<V3f> (rand));
+        px[i]   = p.x;
+        py[i]   = p.y;
+        pz[i]   = p.z;
+        ix[i]   = 1 / rays[i].dir.x;
+        iy[i]   = 1 / rays[i].dir.y;
+        iz[i]   = 1 / rays[i].dir.z;
+
+        V3f c (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        boxes[i] = Box3f (c, c + V3f (rand.nextf (0, 2), rand.nextf (0, 2), rand.nextf (0, 2)));
+    }
+
+    size_t oldHits = 0;
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldHits += intersects (boxes[0], rays[i]);
+    int64_t oet = get_ticks();
+
+    int64_t st     = get_ticks();
+    size_t newHits = intersects (boxes[0], &px[0], &py[0], &pz[0], &ix[0], &iy[0], &iz[0], numentries, hits.get(), &t[0]);
+    int64_t et     = get_ticks();
+
+    if (newHits != oldHits)
+        fprintf (stderr, "ray packet mismatch\n");
+
+    report ("Box3f rays", oet - ost, et - st, numentries);
+
+    oldHits = 0;
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldHits += intersects (boxes[i], rays[0]);
+    oet = get_ticks();
+
+    st      = get_ticks();
+    newHits = intersects (&boxes[0], numentries, rays[0], hits.get(), &t[0]);
+    et      = get_ticks();
+
+    if (newHits != oldHits)
+        fprintf (stderr, "box packet mismatch\n");
+
+    report ("Box3f boxes", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_box_transform (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<Box3f> boxes (numentries), oldResult (numentries), newResult (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f c (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        boxes[i] = Box3f (c, c + V3f (rand.nextf (0, 2), rand.nextf (0, 2), rand.nextf (0, 2)));
+    }
+
+    M44f m;
+    m.setEulerAngles (V3f (0.3f, -1.2f, 2.1f));
+    m.translate (V3f (4, 5, 6));
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldResult[i] = transform (boxes[i], m);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    transform (&boxes[0], numentries, m, &newResult[0]);
+    int64_t et = get_ticks();
+
+    report ("Box3f transform", oet - ost, et - st, numentries);
+
+    Box3f oldBounds;
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldBounds.extendBy (transform (boxes[i], m));
+    oet = get_ticks();
+
+    st             = get_ticks();
+    Box3f newBounds = boundsOf (&boxes[0], numentries, m);
+    et             = get_ticks();
+
+    if (!oldBounds.min.equalWithAbsError (newBounds.min, 1e-3f) ||
+        !oldBounds.max.equalWithAbsError (newBounds.max, 1e-3f))
+        fprintf (stderr, "transformed bounds mismatch\n");
+
+    report ("Box3f transform bounds", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_spatial_sort (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<V3f> points (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+        points[i] = V3f (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+    Box3f bounds = boundsOf (&points[0], numentries);
+
+    std::vector<uint64_t> oldCodes (numentries), newCodes (numentries);
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldCodes[i] = mortonCode (points[i], bounds);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    mortonCodes (&points[0], numentries, bounds, &newCodes[0]);
+    int64_t et = get_ticks();
+
+    if (newCodes != oldCodes)
+        fprintf (stderr, "Morton code mismatch\n");
+
+    report ("V3f Morton codes", oet - ost, et - st, numentries);
+
+    std::vector<uint64_t> oldHilbert (numentries), newHilbert (numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldHilbert[i] = hilbertCode (points[i], bounds);
+    oet = get_ticks();
+
+    st = get_ticks();
+    hilbertCodes (&points[0], numentries, bounds, &newHilbert[0]);
+    et = get_ticks();
+
+    if (newHilbert != oldHilbert)
+        fprintf (stderr, "Hilbert code mismatch\n");
+
+    report ("V3f Hilbert codes", oet - ost, et - st, numentries);
+
+    //
+    // Sorting the codes with their indices, against std::sort of
+    // pairs.
+    //
+
+    std::vector<std::pair<uint64_t, int>> pairs (numentries);
+    std::vector<int> indices (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        pairs[i]   = std::make_pair (oldCodes[i], int (i));
+        indices[i] = int (i);
+    }
+
+    ost = get_ticks();
+    std::sort (pairs.begin(), pairs.end());
+    oet = get_ticks();
+
+    st = get_ticks();
+    radixSort (&newCodes[0], &indices[0], numentries);
+    et = get_ticks();
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        if (newCodes[i] != pairs[i].first)
+        {
+            fprintf (stderr, "radix sort mismatch\n");
+            break;
+        }
+    }
+
+    report ("Morton radix sort", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_frustum_culling (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    Frustumf frustum (0.1f, 1000.0f, 1.0f, 0.0f, 1.5f);
+    M44f cameraMat;
+    cameraMat.setEulerAngles (V3f (0.2f, 0.5f, 0.0f));
+    FrustumTestf frustumTest (frustum, cameraMat);
+
+    std::vector<Box3f> boxes (numentries);
+    std::vector<float> minX (numentries), minY (numentries), minZ (numentries);
+    std::vector<float> maxX (numentries), maxY (numentries), maxZ (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f c (rand.nextf (-500, 500), rand.nextf (-500, 500), rand.nextf (-500, 500));
+        boxes[i] = Box3f (c, c + V3f (rand.nextf (0, 10), rand.nextf (0, 10), rand.nextf (0, 10)));
+
+        minX[i] = boxes[i].min.x, minY[i] = boxes[i].min.y, minZ[i] = boxes[i].min.z;
+        maxX[i] = boxes[i].max.x, maxY[i] = boxes[i].max.y, maxZ[i] = boxes[i].max.z;
+    }
+
+    std::vector<uint64_t> visible ((numentries + 63) / 64);
+    size_t oldVisible = 0;
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldVisible += frustumTest.isVisible (boxes[i]);
+    int64_t oet = get_ticks();
+
+    int64_t st        = get_ticks();
+    size_t newVisible = frustumTest.isVisible (
+        &minX[0], &minY[0], &minZ[0], &maxX[0], &maxY[0], &maxZ[0], numentries, &visible[0]);
+    int64_t et = get_ticks();
+
+    if (newVisible != oldVisible)
+        fprintf (stderr, "frustum culling mismatch\n");
+
+    report ("Box3f frustum culling", oet - ost, et - st, numentries);
+
+    //
+    // Culling a hierarchy over the boxes, with plane masking.
+    //
+
+    BVHf bvh (&boxes[0], numentries);
+    std::vector<int> found;
+    found.reserve (numentries);
+
+    st = get_ticks();
+    bvh.findVisible (frustumTest, found);
+    et = get_ticks();
+
+    if (found.size() != oldVisible)
+        fprintf (stderr, "hierarchical frustum culling mismatch\n");
+
+    report ("BVH frustum culling", oet - ost, et - st, numentries);
+
+    //
+    // Spheres, classified as outside, intersecting or inside.
+    //
+
+    std::vector<Sphere3f> spheres (numentries);
+    std::vector<float> centerX (numentries), centerY (numentries), centerZ (numentries);
+    std::vector<float> radius (numentries);
+    std::vector<uint64_t> contained ((numentries + 63) / 64);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        spheres[i] = Sphere3f (boxes[i].center(), rand.nextf (0, 10));
+
+        centerX[i] = spheres[i].center.x, centerY[i] = spheres[i].center.y;
+        centerZ[i] = spheres[i].center.z, radius[i] = spheres[i].radius;
+    }
+
+    oldVisible          = 0;
+    size_t oldContained = 0;
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        if (frustumTest.isVisible (spheres[i]))
+        {
+            ++oldVisible;
+            oldContained += frustumTest.completelyContains (spheres[i]);
+        }
+    }
+    oet = get_ticks();
+
+    st         = get_ticks();
+    newVisible = frustumTest.classify (
+        &centerX[0], &centerY[0], &centerZ[0], &radius[0], numentries, &visible[0], &contained[0]);
+    et = get_ticks();
+
+    size_t newContained = 0;
+
+    for (size_t w = 0; w < contained.size(); ++w)
+        for (uint64_t bits = contained[w]; bits; bits &= bits - 1)
+            ++newContained;
+
+    if (newVisible != oldVisible || newContained != oldContained)
+        fprintf (stderr, "sphere classification mismatch\n");
+
+    report ("Sphere3f classification", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_frustum_projection (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    Frustumf frustum (0.1f, 1000.0f, 1.0f, 0.0f, 1.5f);
+
+    std::vector<float> x (numentries), y (numentries), z (numentries);
+    std::vector<float> sx (numentries), sy (numentries), nz (numentries);
+    std::vector<V2f> oldScreen (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        x[i] = rand.nextf (-100, 100);
+        y[i] = rand.nextf (-100, 100);
+        z[i] = rand.nextf (-1000, -0.1);
+    }
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldScreen[i] = frustum.projectPointToScreen (V3f (x[i], y[i], z[i]));
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    frustum.projectPointToScreen (&x[0], &y[0], &z[0], numentries, &sx[0], &sy[0]);
+    int64_t et = get_ticks();
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        //
+        // Relative to the whole point, since either coordinate may be
+        // near 0, where the two computations cancel differently.
+        //
+
+        V2f diff = oldScreen[i] - V2f (sx[i], sy[i]);
+
+        if (diff.length() > 1e-5f * std::max (1.0f, oldScreen[i].length()))
+        {
+            fprintf (stderr, "screen projection mismatch\n");
+            break;
+        }
+    }
+
+    report ("Frustumf points to screen", oet - ost, et - st, numentries);
+
+    std::vector<Line3f> oldRays (numentries);
+    std::vector<float> px (numentries), py (numentries), pz (numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldRays[i] = frustum.projectScreenToRay (V2f (sx[i], sy[i]));
+    oet = get_ticks();
+
+    st = get_ticks();
+    frustum.projectScreenToRay (
+        &sx[0], &sy[0], numentries, &px[0], &py[0], &pz[0], &x[0], &y[0], &z[0]);
+    et = get_ticks();
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        if (!oldRays[i].dir.equalWithAbsError (V3f (x[i], y[i], z[i]), 1e-5f))
+        {
+            fprintf (stderr, "screen ray mismatch\n");
+            break;
+        }
+    }
+
+    report ("Frustumf screen to rays", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_ray_triangles (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<V3f> v0 (numentries), v1 (numentries), v2 (numentries);
+    std::vector<float> v0x (numentries), v0y (numentries), v0z (numentries);
+    std::vector<float> v1x (numentries), v1y (numentries), v1z (numentries);
+    std::vector<float> v2x (numentries), v2y (numentries), v2z (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f c (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+        v0[i] = c + solidSphereRand<V3f> (rand) * 0.1f;
+        v1[i] = c + solidSphereRand<V3f> (rand) * 0.1f;
+        v2[i] = c + solidSphereRand<V3f> (rand) * 0.1f;
+
+        v0x[i] = v0[i].x, v0y[i] = v0[i].y, v0z[i] = v0[i].z;
+        v1x[i] = v1[i].x, v1y[i] = v1[i].y, v1z[i] = v1[i].z;
+        v2x[i] = v2[i].x, v2y[i] = v2[i].y, v2z[i] = v2[i].z;
+    }
+
+    //
+    // One ray against all the triangles, with the nearest hit found
+    // with the single-triangle intersect().
+    //
+
+    Line3f ray (V3f (-20, -1, 0.5f), V3f (20, 1, -0.5f));
+
+    int oldNearest = -1;
+    float oldT     = 0;
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f pt, bary;
+        bool front;
+
+        if (intersect (ray, v0[i], v1[i], v2[i], pt, bary, front))
+        {
+            float t = (pt - ray.pos) ^ ray.dir;
+
+            if (t >= 0 && (oldNearest < 0 || t < oldT))
+            {
+                oldNearest = int (i);
+                oldT       = t;
+            }
+        }
+    }
+    int64_t oet = get_ticks();
+
+    float newT;
+    V3f bary;
+
+    int64_t st     = get_ticks();
+    int newNearest = intersect (ray,
+                                &v0x[0],
+                                &v0y[0],
+                                &v0z[0],
+                                &v1x[0],
+                                &v1y[0],
+                                &v1z[0],
+                                &v2x[0],
+                                &v2y[0],
+                                &v2z[0],
+                                numentries,
+                                newT,
+                                bary);
+    int64_t et = get_ticks();
+
+    if (newNearest != oldNearest)
+        fprintf (stderr, "ray-triangle nearest hit mismatch\n");
+
+    report ("Triangles vs ray", oet - ost, et - st, numentries);
+
+    //
+    // All the rays against one triangle
+    //
+
+    std::vector<float> posX (numentries), posY (numentries), posZ (numentries);
+    std::vector<float> dirX (numentries), dirY (numentries), dirZ (numentries);
+    std::vector<float> t (numentries), u (numentries), v (numentries);
+    std::unique_ptr<bool[]> hits (new bool[numentries]);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        posX[i] = rand.nextf (-1, 1), posY[i] = rand.nextf (-1, 1), posZ[i] = 5;
+        dirX[i] = 0, dirY[i] = 0, dirZ[i] = -1;
+    }
+
+    V3f a (-1, -1, 0), b (1, -1, 0), c (0, 1, 0);
+    size_t oldHits = 0;
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f pt;
+        bool front;
+        V3f p (posX[i], posY[i], posZ[i]);
+
+        oldHits += intersect (Line3f (p, p + V3f (dirX[i], dirY[i], dirZ[i])), a, b, c, pt, bary, front);
+    }
+    oet = get_ticks();
+
+    st             = get_ticks();
+    size_t newHits = intersect (a,
+                                b,
+                                c,
+                                &posX[0],
+                                &posY[0],
+                                &posZ[0],
+                                &dirX[0],
+                                &dirY[0],
+                                &dirZ[0],
+                                numentries,
+                                hits.get(),
+                                &t[0],
+                                &u[0],
+                                &v[0]);
+    et = get_ticks();
+
+    if (newHits != oldHits)
+        fprintf (stderr, "ray-triangle packet mismatch\n");
+
+    report ("Rays vs triangle", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_closest_points (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    //
+    // The line nearest to a line, with the scalar closestPoints()
+    //
+
+    std::vector<Line3f> lines (numentries);
+    std::vector<float> posX (numentries), posY (numentries), posZ (numentries);
+    std::vector<float> dirX (numentries), dirY (numentries), dirZ (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f p (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        V3f d = hollowSphereRand<V3f> (rand);
+
+        lines[i] = Line3f (p, p + d);
+        posX[i] = p.x, posY[i] = p.y, posZ[i] = p.z;
+        dirX[i] = lines[i].dir.x, dirY[i] = lines[i].dir.y, dirZ[i] = lines[i].dir.z;
+    }
+
+    Line3f line (V3f (-20, -1, 0.5f), V3f (20, 1, -0.5f));
+
+    int oldNearest = -1;
+    float oldD2    = 0;
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f p1, p2;
+
+        if (!closestPoints (line, lines[i], p1, p2))
+            p1 = line.pos, p2 = lines[i].closestPointTo (line.pos);
+
+        float d2 = (p1 - p2).length2();
+
+        if (oldNearest < 0 || d2 < oldD2)
+        {
+            oldNearest = int (i);
+            oldD2      = d2;
+        }
+    }
+    int64_t oet = get_ticks();
+
+    V3f p1, p2;
+
+    int64_t st = get_ticks();
+    int newNearest =
+        closestLine (line, &posX[0], &posY[0], &posZ[0], &dirX[0], &dirY[0], &dirZ[0], numentries, p1, p2);
+    int64_t et = get_ticks();
+
+    if (newNearest != oldNearest)
+        fprintf (stderr, "closest line mismatch\n");
+
+    report ("Closest line", oet - ost, et - st, numentries);
+
+    //
+    // The point nearest to a line
+    //
+
+    std::vector<V3f> points (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+        points[i] = V3f (posX[i], posY[i], posZ[i]);
+
+    oldNearest = 0;
+    oldD2      = (points[0] - line.closestPointTo (points[0])).length2();
+
+    ost = get_ticks();
+    for (size_t i = 1; i < numentries; ++i)
+    {
+        float d2 = (points[i] - line.closestPointTo (points[i])).length2();
+
+        if (d2 < oldD2)
+        {
+            oldNearest = int (i);
+            oldD2      = d2;
+        }
+    }
+    oet = get_ticks();
+
+    st         = get_ticks();
+    newNearest = closestVertex (&posX[0], &posY[0], &posZ[0], numentries, line);
+    et         = get_ticks();
+
+    if (newNearest != oldNearest)
+        fprintf (stderr, "closest vertex mismatch\n");
+
+    report ("Closest vertex", oet - ost, et - st, numentries);
+
+    //
+    // Points snapped to the surface of a box
+    //
+
+    Box3f box (V3f (-5), V3f (5));
+    std::vector<V3f> oldQ (numentries);
+    std::vector<float> qx (numentries), qy (numentries), qz (numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldQ[i] = closestPointOnBox (points[i], box);
+    oet = get_ticks();
+
+    st = get_ticks();
+    closestPointOnBox (&posX[0], &posY[0], &posZ[0], numentries, box, &qx[0], &qy[0], &qz[0]);
+    et = get_ticks();
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        if (oldQ[i] != V3f (qx[i], qy[i], qz[i]))
+        {
+            fprintf (stderr, "closest point on box mismatch\n");
+            break;
+        }
+    }
+
+    report ("Closest points on box", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_plane_classify (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<V3f> points (numentries);
+    std::vector<float> x (numentries), y (numentries), z (numentries), distances (numentries);
+    std::vector<uint64_t> oldAbove ((numentries + 63) / 64), newAbove ((numentries + 63) / 64);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        points[i] = V3f (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        x[i] = points[i].x, y[i] = points[i].y, z[i] = points[i].z;
+    }
+
+    Plane3f plane (V3f (1, 2, 3), V3f (0.2f, -1, 0.5f));
+
+    size_t oldCount = 0;
+
+    int64_t ost = get_ticks();
+    std::fill (oldAbove.begin(), oldAbove.end(), 0);
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        float d      = plane.distanceTo (points[i]);
+        distances[i] = d;
+
+        if (d > 0)
+        {
+            oldAbove[i / 64] |= uint64_t (1) << (i % 64);
+            ++oldCount;
+        }
+    }
+    int64_t oet = get_ticks();
+
+    int64_t st      = get_ticks();
+    size_t newCount = plane.classify (&x[0], &y[0], &z[0], numentries, &distances[0], &newAbove[0]);
+    int64_t et      = get_ticks();
+
+    if (newCount != oldCount || newAbove != oldAbove)
+        fprintf (stderr, "plane classification mismatch\n");
+
+    report ("Plane3f classify", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_bounding_spheres (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    //
+    // Points in a rotated, flattened ellipsoid, for which the sphere
+    // around the bounding box is loose.
+    //
+
+    std::vector<V3f> points (numentries);
+    M44f m;
+    m.setEulerAngles (V3f (0.3f, 0.7f, -0.4f));
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        V3f p     = solidSphereRand<V3f> (rand);
+        points[i] = V3f (p.x * 10, p.y * 4, p.z) * m;
+    }
+
+    Sphere3f boxSphere, ritter, minimal;
+
+    int64_t ost = get_ticks();
+    boxSphere.circumscribe (boundsOf (&points[0], numentries));
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    ritter.circumscribe (&points[0], numentries);
+    int64_t et = get_ticks();
+
+    report ("Sphere3f Ritter", oet - ost, et - st, numentries);
+
+    st = get_ticks();
+    minimal.circumscribeMinimal (&points[0], numentries);
+    et = get_ticks();
+
+    report ("Sphere3f minimal", oet - ost, et - st, numentries);
+
+    fprintf (stderr,
+             "%-24s radius: box %g, Ritter %g, minimal %g\n",
+             "Sphere3f",
+             boxSphere.radius,
+             ritter.radius,
+             minimal.radius);
+}
+
+void
+perf_test_roots (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<float> a (numentries), b (numentries), c (numentries), d (numentries);
+    std::vector<float> x0 (numentries), x1 (numentries), x2 (numentries);
+    std::vector<float> oldX (3 * numentries);
+    std::vector<int> oldCount (numentries), newCount (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        a[i] = rand.nextf (-10, 10);
+        b[i] = rand.nextf (-10, 10);
+        c[i] = rand.nextf (-10, 10);
+        d[i] = rand.nextf (-10, 10);
+    }
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldCount[i] = solveQuadratic (a[i], b[i], c[i], &oldX[2 * i]);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    solveQuadratic (&a[0], &b[0], &c[0], numentries, &x0[0], &x1[0], &newCount[0]);
+    int64_t et = get_ticks();
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        if (newCount[i] != oldCount[i] || (oldCount[i] > 0 && x0[i] != oldX[2 * i]))
+        {
+            fprintf (stderr, "quadratic roots mismatch at %zu\n", i);
+            break;
+        }
+    }
+
+    report ("solveQuadratic", oet - ost, et - st, numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldCount[i] = solveCubic (a[i], b[i], c[i], d[i], &oldX[3 * i]);
+    oet = get_ticks();
+
+    st = get_ticks();
+    solveCubic (&a[0], &b[0], &c[0], &d[0], numentries, &x0[0], &x1[0], &x2[0], &newCount[0]);
+    et = get_ticks();
+
+    if (newCount != oldCount)
+        fprintf (stderr, "cubic root count mismatch\n");
+
+    report ("solveCubic", oet - ost, et - st, numentries);
+}
+
+//
+// Real solutions of a quartic equation, with the Durand-Kerner
+// iteration that generic polynomial solvers use, for comparison.
+//
+
+int
+durandKerner (float a, float b, float c, float d, float e, float x[4])
+{
+    typedef std::complex<double> C;
+
+    C z[4] = { C (1, 0), C (0.4, 0.9) };
+
+    for (int i = 2; i < 4; ++i)
+        z[i] = z[i - 1] * z[1];
+
+    for (int iter = 0; iter < 100; ++iter)
+    {
+        double change = 0;
+
+        for (int i = 0; i < 4; ++i)
+        {
+            C f = (((C (a) * z[i] + C (b)) * z[i] + C (c)) * z[i] + C (d)) * z[i] + C (e);
+            C g = C (a);
+
+            for (int j = 0; j < 4; ++j)
+                if (j != i)
+                    g *= z[i] - z[j];
+
+            C dz = f / g;
+            z[i] -= dz;
+            change = std::max (change, std::abs (dz));
+        }
+
+        if (change < 1e-7)
+            break;
+    }
+
+    int n = 0;
+
+    for (int i = 0; i < 4; ++i)
+        if (std::abs (z[i].imag()) <= 1e-4 * (1 + std::abs (z[i].real())))
+            x[n++] = float (z[i].real());
+
+    return n;
+}
+
+void
+perf_test_quartic (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<float> a (numentries), b (numentries), c (numentries), d (numentries);
+    std::vector<float> e (numentries);
+    std::vector<float> x0 (numentries), x1 (numentries), x2 (numentries), x3 (numentries);
+    std::vector<float> oldX (4 * numentries);
+    std::vector<int> oldCount (numentries), newCount (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        a[i] = rand.nextf (0.5, 10) * (i % 2 ? 1 : -1);
+        b[i] = rand.nextf (-10, 10);
+        c[i] = rand.nextf (-10, 10);
+        d[i] = rand.nextf (-10, 10);
+        e[i] = rand.nextf (-10, 10);
+    }
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldCount[i] = durandKerner (a[i], b[i], c[i], d[i], e[i], &oldX[4 * i]);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        newCount[i] = solveQuartic (a[i], b[i], c[i], d[i], e[i], &oldX[4 * i]);
+    int64_t et = get_ticks();
+
+    report ("solveQuartic iterative", oet - ost, et - st, numentries);
+
+    size_t differentCounts = 0;
+
+    for (size_t i = 0; i < numentries; ++i)
+        differentCounts += newCount[i] != oldCount[i];
+
+    fprintf (stderr,
+             "%-24s %zu of %zu solution counts differ from the iteration\n",
+             "solveQuartic",
+             differentCounts,
+             numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldCount[i] = solveQuartic (a[i], b[i], c[i], d[i], e[i], &oldX[4 * i]);
+    oet = get_ticks();
+
+    st = get_ticks();
+    solveQuartic (&a[0],
+                  &b[0],
+                  &c[0],
+                  &d[0],
+                  &e[0],
+                  numentries,
+                  &x0[0],
+                  &x1[0],
+                  &x2[0],
+                  &x3[0],
+                  &newCount[0]);
+    et = get_ticks();
+
+    if (newCount != oldCount)
+        fprintf (stderr, "quartic root count mismatch\n");
+
+    report ("solveQuartic batched", oet - ost, et - st, numentries);
+}
+
+void
+perf_test_hsv (size_t numentries)
+{
+    Rand48 rand (numentries);
+
+    std::vector<C3f> rgb (numentries), oldHsv (numentries), newHsv (numentries);
+    std::vector<C3h> rgbh (numentries), oldHsvh (numentries), newHsvh (numentries);
+    std::vector<float> r (numentries), g (numentries), b (numentries);
+    std::vector<float> h (numentries), s (numentries), v (numentries);
+
+    for (size_t i = 0; i < numentries; ++i)
+    {
+        rgb[i]  = C3f (rand.nextf (0, 1), rand.nextf (0, 1), rand.nextf (0, 1));
+        rgbh[i] = C3h (half (rgb[i].x), half (rgb[i].y), half (rgb[i].z));
+        r[i]    = rgb[i].x;
+        g[i]    = rgb[i].y;
+        b[i]    = rgb[i].z;
+    }
+
+    int64_t ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldHsv[i] = rgb2hsv (rgb[i]);
+    int64_t oet = get_ticks();
+
+    int64_t st = get_ticks();
+    rgb2hsv (&rgb[0], numentries, &newHsv[0]);
+    int64_t et = get_ticks();
+
+    report ("rgb2hsv C3f", oet - ost, et - st, numentries);
+
+    st = get_ticks();
+    rgb2hsv (&r[0], &g[0], &b[0], numentries, &h[0], &s[0], &v[0]);
+    et = get_ticks();
+
+    report ("rgb2hsv planar", oet - ost, et - st, numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        rgb[i] = hsv2rgb (oldHsv[i]);
+    oet = get_ticks();
+
+    st = get_ticks();
+    hsv2rgb (&newHsv[0], numentries, &newHsv[0]);
+    et = get_ticks();
+
+    report ("hsv2rgb C3f", oet - ost, et - st, numentries);
+
+    st = get_ticks();
+    hsv2rgb (&h[0], &s[0], &v[0], numentries, &r[0], &g[0], &b[0]);
+    et = get_ticks();
+
+    report ("hsv2rgb planar", oet - ost, et - st, numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        oldHsvh[i] = rgb2hsv (rgbh[i]);
+    oet = get_ticks();
+
+    st = get_ticks();
+    rgb2hsv (&rgbh[0], numentries, &newHsvh[0]);
+    et = get_ticks();
+
+    report ("rgb2hsv C3h", oet - ost, et - st, numentries);
+
+    ost = get_ticks();
+    for (size_t i = 0; i < numentries; ++i)
+        rgbh[i] = hsv2rgb (oldHsvh[i]);
+    oet = get_ticks();
+
+    st = get_ticks();
+    hsv2rgb (&newHsvh[0], numentries, &newHsvh[0]);
+    et = get_ticks();
+
+    report ("hsv2rgb C3h", oet - ost, et - st, numentries);
+}
+
+int
+main (int argc, char* argv[])
+{
+    int ret        = 0;
+    int numentries = 1000000;
+    if (argc > 1)
+    {
+        numentries = atoi (argv[1]);
+
+        if (numentries <= 0)
+        {
+            fprintf (stderr, "Bad entry count '%s'\n", argv[1]);
+            ret = 1;
+        }
+    }
+
+    if (numentries > 0)
+    {
+        perf_test_quat_conversions (numentries);
+        perf_test_euler_conversions (numentries);
+        perf_test_euler_unwrap (numentries);
+        perf_test_vec_array (numentries);
+        perf_test_bounds (numentries);
+        perf_test_bvh (numentries);
+        perf_test_ray_packets (numentries);
+        perf_test_box_transform (numentries);
+        perf_test_spatial_sort (numentries);
+        perf_test_frustum_culling (numentries);
+        perf_test_frustum_projection (numentries);
+        perf_test_ray_triangles (numentries);
+        perf_test_closest_points (numentries);
+        perf_test_plane_classify (numentries);
+        perf_test_bounding_spheres (numentries);
+        perf_test_roots (numentries);
+        perf_test_quartic (numentries);
+        perf_test_hsv (numentries);
+    }
+
+    return ret;
+}
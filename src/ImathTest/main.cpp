@@ -15,9 +15,11 @@
 #include "testLimits.h"
 #include "testSize.h"
 #include "testToFloat.h"
+#include "testBVH.h"
 #include "testBox.h"
 #include "testBoxAlgo.h"
 #include "testColor.h"
+#include "testDualQuat.h"
 #include "testExtractEuler.h"
 #include "testExtractSHRT.h"
 #include "testFrustum.h"
@@ -30,15 +32,20 @@
 #include "testLineAlgo.h"
 #include "testMatrix.h"
 #include "testMiscMatrixAlgo.h"
+#include "testPlane.h"
 #include "testProcrustes.h"
 #include "testQuat.h"
 #include "testQuatSetRotation.h"
 #include "testQuatSlerp.h"
+#include "testQuatSpline.h"
 #include "testRandom.h"
 #include "testRoots.h"
 #include "testShear.h"
+#include "testSpatialSort.h"
+#include "testSphere.h"
 #include "testTinySVD.h"
 #include "testVec.h"
+#include "testVecArray.h"
 
 #include <iostream>
 #include <string.h>
@@ -87,6 +94,13 @@ main (int argc, char* argv[])
     TEST (testJacobiEigenSolver);
     TEST (testFrustumTest);
     TEST (testInterop);
+    TEST (testQuatSpline);
+    TEST (testDualQuat);
+    TEST (testVecArray);
+    TEST (testBVH);
+    TEST (testSpatialSort);
+    TEST (testPlane);
+    TEST (testSphere);
     // NB: If you add a test here, make sure to enumerate it in the
     // CMakeLists.txt so it runs as part of the test suite
 
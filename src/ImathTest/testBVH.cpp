@@ -0,0 +1,251 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathBVH.h>
+#include <ImathRandom.h>
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <vector>
+#include "testBVH.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+std::vector<Box<Vec3<T>>>
+randomBoxes (Rand48& rand, size_t n, T maxSize)
+{
+    std::vector<Box<Vec3<T>>> boxes (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> p (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        Vec3<T> s (rand.nextf (0, maxSize), rand.nextf (0, maxSize), rand.nextf (0, maxSize));
+        boxes[i] = Box<Vec3<T>> (p, p + s);
+    }
+
+    return boxes;
+}
+
+std::vector<int>
+sorted (std::vector<int> v)
+{
+    std::sort (v.begin(), v.end());
+    return v;
+}
+
+template <class T>
+void
+testQueries (const std::vector<Box<Vec3<T>>>& boxes, int maxLeafSize)
+{
+    Rand48 rand (boxes.size());
+
+    const size_t n = boxes.size();
+    BVH<T> bvh (boxes.empty() ? 0 : &boxes[0], n, maxLeafSize);
+
+    assert (bvh.size() == n);
+
+    Box<Vec3<T>> all;
+
+    for (size_t i = 0; i < n; ++i)
+        all.extendBy (boxes[i]);
+
+    assert (bvh.bounds() == all);
+
+    for (int q = 0; q < 200; ++q)
+    {
+        //
+        // Rays, including rays along the axes, which exercise the
+        // infinite reciprocal directions of the slab test.
+        //
+
+        Vec3<T> p (rand.nextf (-15, 15), rand.nextf (-15, 15), rand.nextf (-15, 15));
+        Vec3<T> d = hollowSphereRand<Vec3<T>> (rand);
+
+        if (q % 10 == 0)
+            d = Vec3<T> (0, 0, 0), d[q / 10 % 3] = (q % 20) ? 1 : -1;
+
+        Line3<T> ray (p, p + d);
+
+        std::vector<int> expected, found;
+
+        for (size_t i = 0; i < n; ++i)
+            if (intersects (boxes[i], ray))
+                expected.push_back (int (i));
+
+        assert (bvh.findIntersecting (ray, found) == found.size());
+        assert (sorted (found) == expected);
+
+        T t;
+        int closest = bvh.findClosest (ray, t);
+
+        int expectedClosest = -1;
+        T expectedT         = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> ip;
+
+            if (intersects (boxes[i], ray, ip))
+            {
+                T d = (ip - ray.pos) ^ ray.dir;
+
+                if (expectedClosest < 0 || d < expectedT)
+                {
+                    expectedT       = d;
+                    expectedClosest = int (i);
+                }
+            }
+        }
+
+        assert (closest == expectedClosest);
+        assert (closest < 0 || equalWithAbsError (t, expectedT, T (1e-5)));
+
+        //
+        // Boxes
+        //
+
+        Vec3<T> c (rand.nextf (-12, 12), rand.nextf (-12, 12), rand.nextf (-12, 12));
+        Box<Vec3<T>> box (c, c + Vec3<T> (rand.nextf (0, 3), rand.nextf (0, 3), rand.nextf (0, 3)));
+
+        expected.clear();
+        found.clear();
+
+        for (size_t i = 0; i < n; ++i)
+            if (boxes[i].intersects (box))
+                expected.push_back (int (i));
+
+        assert (bvh.findIntersecting (box, found) == found.size());
+        assert (sorted (found) == expected);
+
+        //
+        // Points, appending to a non-empty result.
+        //
+
+        expected.assign (1, -1);
+        found.assign (1, -1);
+
+        for (size_t i = 0; i < n; ++i)
+            if (boxes[i].intersects (c))
+                expected.push_back (int (i));
+
+        assert (bvh.findContaining (c, found) == found.size() - 1);
+        assert (sorted (found) == expected);
+
+        //
+        // Frustums, looking from inside and outside the boxes
+        //
+
+        Frustum<T> frustum (T (0.1), T (rand.nextf (5, 40)), T (-1), T (1), T (0.8), T (-0.6), q % 7 == 0);
+
+        Matrix44<T> cameraMat;
+        cameraMat.setEulerAngles (Vec3<T> (rand.nextf (-3, 3), rand.nextf (-3, 3), rand.nextf (-3, 3)));
+        cameraMat.translate (p);
+
+        FrustumTest<T> frustumTest (frustum, cameraMat);
+
+        expected.clear();
+        found.clear();
+
+        for (size_t i = 0; i < n; ++i)
+            if (frustumTest.isVisible (boxes[i]))
+                expected.push_back (int (i));
+
+        assert (bvh.findVisible (frustumTest, found) == found.size());
+        assert (sorted (found) == expected);
+    }
+}
+
+template <class T>
+void
+testBVHT()
+{
+    Rand48 rand (0);
+
+    //
+    // Empty and single-primitive hierarchies
+    //
+
+    BVH<T> empty;
+    std::vector<int> found;
+    T t;
+
+    assert (empty.size() == 0 && empty.numNodes() == 0);
+    assert (empty.bounds().isEmpty());
+    assert (empty.findContaining (Vec3<T> (0), found) == 0);
+    assert (empty.findClosest (Line3<T> (Vec3<T> (0), Vec3<T> (1, 0, 0)), t) == -1);
+
+    std::vector<Box<Vec3<T>>> one (1, Box<Vec3<T>> (Vec3<T> (1), Vec3<T> (2)));
+    BVH<T> single (&one[0], 1);
+
+    assert (single.numNodes() == 1);
+    assert (single.findClosest (Line3<T> (Vec3<T> (0), Vec3<T> (1)), t) == 0);
+    assert (equalWithAbsError (t, T (std::sqrt (3.0)), T (1e-5)));
+
+    //
+    // Random boxes of different densities and leaf sizes
+    //
+
+    for (int maxLeafSize = 1; maxLeafSize <= 8; maxLeafSize *= 2)
+    {
+        testQueries (randomBoxes<T> (rand, 1000, T (1)), maxLeafSize);
+        testQueries (randomBoxes<T> (rand, 300, T (8)), maxLeafSize);
+    }
+
+    //
+    // Degenerate and duplicate boxes: the centroids coincide, or lie
+    // on a plane.
+    //
+
+    std::vector<Box<Vec3<T>>> boxes (100, Box<Vec3<T>> (Vec3<T> (-1), Vec3<T> (1)));
+    testQueries (boxes, 4);
+
+    BVH<T> same (&boxes[0], boxes.size(), 4);
+    assert (same.numNodes() == 1);
+
+    for (size_t i = 0; i < boxes.size(); ++i)
+        boxes[i] = Box<Vec3<T>> (Vec3<T> (T (i), T (i % 7), 0));
+
+    testQueries (boxes, 2);
+
+    //
+    // Boxes clustered at very different scales, which unbalance the
+    // surface area splits.
+    //
+
+    boxes = randomBoxes<T> (rand, 500, T (1));
+
+    for (size_t i = 0; i < boxes.size(); i += 2)
+    {
+        boxes[i].min *= T (1e-4);
+        boxes[i].max *= T (1e-4);
+    }
+
+    testQueries (boxes, 1);
+}
+
+} // namespace
+
+void
+testBVH()
+{
+    cout << "Testing bounding volume hierarchies" << endl;
+
+    cout << "  float" << endl;
+    testBVHT<float>();
+
+    cout << "  double" << endl;
+    testBVHT<double>();
+
+    cout << "ok\n" << endl;
+}
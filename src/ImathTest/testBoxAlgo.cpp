@@ -12,6 +12,8 @@
 #include <algorithm>
 #include <assert.h>
 #include <iostream>
+#include <limits>
+#include <vector>
 #include "testBoxAlgo.h"
 
 using namespace std;
@@ -891,6 +893,450 @@ pointInAndOnBox()
     assert (closestPointInBox (V3f (3, 3, 4.5), box) == V3f (3, 3, 4.5));
 }
 
+template <class V>
+void
+boundsOfPoints (Rand48& rand)
+{
+    typedef typename V::BaseType T;
+
+    //
+    // boundsOf() matches extending an empty box by each point, for
+    // all remainders modulo the group size, with and without index
+    // lists. Points containing NaN are ignored, as by extendBy().
+    //
+
+    std::vector<V> points (100);
+    std::vector<int> indices (200);
+
+    for (size_t i = 0; i < points.size(); ++i)
+        for (unsigned int j = 0; j < V::dimensions(); ++j)
+            points[i][j] = T (rand.nextf (-100, 100));
+
+    for (size_t i = 0; i < indices.size(); ++i)
+        indices[i] = rand.nexti() % points.size();
+
+    points[37][0] = std::numeric_limits<T>::quiet_NaN();
+
+    assert (boundsOf (&points[0], 0).isEmpty());
+    assert (boundsOf (&points[0], &indices[0], 0).isEmpty());
+
+    for (size_t n = 1; n <= points.size(); ++n)
+    {
+        Box<V> b;
+
+        for (size_t i = 0; i < n; ++i)
+            b.extendBy (points[i]);
+
+        assert (boundsOf (&points[0], n) == b);
+
+        Box<V> c;
+
+        for (size_t i = 0; i < n; ++i)
+            c.extendBy (points[indices[i]]);
+
+        assert (boundsOf (&points[0], &indices[0], n) == c);
+    }
+
+    //
+    // The bounds of separate ranges combine to the bounds of the whole.
+    //
+
+    Box<V> b = boundsOf (&points[0], 33);
+    b.extendBy (boundsOf (&points[33], points.size() - 33));
+
+    assert (b == boundsOf (&points[0], points.size()));
+}
+
+void
+boundsOfPoints()
+{
+    cout << "  bounds of point arrays" << endl;
+
+    Rand48 rand (0);
+
+    boundsOfPoints<V2f> (rand);
+    boundsOfPoints<V2d> (rand);
+    boundsOfPoints<V3f> (rand);
+    boundsOfPoints<V3d> (rand);
+}
+
+template <class T>
+void
+rayPackets (Rand48& rand)
+{
+    const size_t n = 500;
+    const T e      = T (1e-4);
+
+    std::vector<Box<Vec3<T>>> boxes (n);
+    std::vector<Line3<T>> rays (n);
+    std::vector<T> px (n), py (n), pz (n), ix (n), iy (n), iz (n), t (n);
+    bool h[n];
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> p (rand.nextf (-4, 4), rand.nextf (-4, 4), rand.nextf (-4, 4));
+        Vec3<T> d = hollowSphereRand<Vec3<T>> (rand);
+
+        //
+        // Include rays parallel to the axes.
+        //
+
+        if (i % 10 == 0)
+            d = Vec3<T> (0), d[i / 10 % 3] = (i % 20) ? 1 : -1;
+
+        rays[i] = Line3<T> (p, p + d);
+        px[i]   = p.x;
+        py[i]   = p.y;
+        pz[i]   = p.z;
+        ix[i]   = 1 / rays[i].dir.x;
+        iy[i]   = 1 / rays[i].dir.y;
+        iz[i]   = 1 / rays[i].dir.z;
+
+        Vec3<T> c (rand.nextf (-3, 3), rand.nextf (-3, 3), rand.nextf (-3, 3));
+        boxes[i] = Box<Vec3<T>> (c, c + Vec3<T> (rand.nextf (0, 2), rand.nextf (0, 2), rand.nextf (0, 2)));
+    }
+
+    //
+    // Many rays against one box
+    //
+
+    for (size_t b = 0; b < 20; ++b)
+    {
+        size_t count         = intersects (boxes[b], &px[0], &py[0], &pz[0], &ix[0], &iy[0], &iz[0], n, h, &t[0]);
+        size_t expectedCount = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> ip (T (0));
+            bool hit = intersects (boxes[b], rays[i], ip);
+
+            assert (h[i] == hit);
+            assert (hit ? equalWithAbsError (t[i], (ip - rays[i].pos) ^ rays[i].dir, e)
+                        : t[i] == std::numeric_limits<T>::infinity());
+
+            expectedCount += hit;
+        }
+
+        assert (count == expectedCount);
+    }
+
+    //
+    // One ray against many boxes
+    //
+
+    for (size_t r = 0; r < 20; ++r)
+    {
+        size_t count         = intersects (&boxes[0], n, rays[r], h, &t[0]);
+        size_t expectedCount = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> ip (T (0));
+            bool hit = intersects (boxes[i], rays[r], ip);
+
+            assert (h[i] == hit);
+            assert (hit ? equalWithAbsError (t[i], (ip - rays[r].pos) ^ rays[r].dir, e)
+                        : t[i] == std::numeric_limits<T>::infinity());
+
+            expectedCount += hit;
+        }
+
+        assert (count == expectedCount);
+    }
+
+    //
+    // Rays parallel to a face, starting in the plane of the face,
+    // with positive and negative zero direction components.
+    //
+
+    Box<Vec3<T>> box (Vec3<T> (0), Vec3<T> (1));
+    T tEntry;
+
+    for (int s = 0; s < 2; ++s)
+    {
+        T zero = s ? T (-0.0) : T (0);
+        Vec3<T> invDir (1 / zero, 1 / zero, 1);
+
+        assert (intersects (box, Vec3<T> (0, 1, -1), invDir, tEntry) && tEntry == 1);
+        assert (intersects (box, Vec3<T> (1, 0, -1), invDir, tEntry) && tEntry == 1);
+        assert (!intersects (box, Vec3<T> (2, 0, -1), invDir, tEntry));
+    }
+
+    //
+    // Rays starting inside, boxes behind the ray, and empty boxes
+    //
+
+    Vec3<T> invDir (1, 1, 1);
+
+    assert (intersects (box, Vec3<T> (T (0.5)), invDir, tEntry) && tEntry == 0);
+    assert (!intersects (box, Vec3<T> (2), invDir, tEntry));
+    assert (!intersects (Box<Vec3<T>>(), Vec3<T> (T (-0.5)), invDir, tEntry));
+}
+
+void
+rayPackets()
+{
+    cout << "  ray packets" << endl;
+
+    Rand48 rand (0);
+
+    rayPackets<float> (rand);
+    rayPackets<double> (rand);
+}
+
+template <class T>
+bool
+boxesEqual (const Box<Vec3<T>>& a, const Box<Vec3<T>>& b, T e)
+{
+    if (a.isEmpty() || a.isInfinite() || b.isEmpty() || b.isInfinite())
+        return a == b;
+
+    return a.min.equalWithAbsError (b.min, e) && a.max.equalWithAbsError (b.max, e);
+}
+
+template <class T>
+void
+batchedBoxTransforms (Rand48& rand)
+{
+    const size_t n = 300;
+    const T e      = T (1e-3);
+
+    std::vector<Box<Vec3<T>>> boxes (n), result (n);
+    std::vector<Matrix44<T>> mats (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+        Vec3<T> s (rand.nextf (0, 3), rand.nextf (0, 3), rand.nextf (0, 3));
+        boxes[i] = Box<Vec3<T>> (c, c + s);
+
+        mats[i].setEulerAngles (Vec3<T> (rand.nextf (-3, 3), rand.nextf (-3, 3), rand.nextf (-3, 3)));
+        mats[i].scale (Vec3<T> (rand.nextf (-2, 2), rand.nextf (-2, 2), rand.nextf (-2, 2)));
+        mats[i].translate (Vec3<T> (rand.nextf (-5, 5), rand.nextf (-5, 5), rand.nextf (-5, 5)));
+    }
+
+    //
+    // Empty, infinite, non-canonical empty, and degenerate boxes
+    //
+
+    boxes[5].makeEmpty();
+    boxes[70].makeInfinite();
+    boxes[71] = Box<Vec3<T>> (Vec3<T> (1, 1, 1), Vec3<T> (0, 2, 2));
+    boxes[72] = Box<Vec3<T>> (Vec3<T> (1, 2, 3));
+
+    //
+    // One affine matrix for all the boxes
+    //
+
+    const Matrix44<T>& m = mats[0];
+
+    affineTransform (&boxes[0], n, m, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (boxesEqual (result[i], affineTransform (boxes[i], m), e));
+
+    assert (result[71] == boxes[71]);
+
+    transform (&boxes[0], n, m, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (boxesEqual (result[i], transform (boxes[i], m), e));
+
+    Box<Vec3<T>> expected;
+
+    for (size_t i = 0; i < n; ++i)
+        expected.extendBy (transform (boxes[i], m));
+
+    //
+    // The union is infinite because of boxes[70]; without it, the
+    // union is finite.
+    //
+
+    assert (boxesEqual (boundsOf (&boxes[0], n, m), expected, e));
+    assert (boundsOf (&boxes[0], n, m).isInfinite());
+
+    boxes[70] = boxes[69];
+    expected.makeEmpty();
+
+    for (size_t i = 0; i < n; ++i)
+        expected.extendBy (transform (boxes[i], m));
+
+    assert (boxesEqual (boundsOf (&boxes[0], n, m), expected, e));
+    assert (boundsOf (&boxes[0], 0, m).isEmpty());
+
+    //
+    // The same, in place
+    //
+
+    result = boxes;
+    affineTransform (&result[0], n, m, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (boxesEqual (result[i], affineTransform (boxes[i], m), e));
+
+    //
+    // A projection matrix
+    //
+
+    Matrix44<T> p = m;
+    p[0][3]       = T (0.01);
+    p[3][3]       = 2;
+
+    transform (&boxes[0], n, p, &result[0]);
+
+    expected.makeEmpty();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (result[i] == transform (boxes[i], p));
+        expected.extendBy (result[i]);
+    }
+
+    assert (boundsOf (&boxes[0], n, p) == expected);
+
+    //
+    // A matrix per box
+    //
+
+    affineTransform (&boxes[0], &mats[0], n, &result[0]);
+
+    expected.makeEmpty();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (boxesEqual (result[i], affineTransform (boxes[i], mats[i]), e));
+        expected.extendBy (affineTransform (boxes[i], mats[i]));
+    }
+
+    assert (boxesEqual (boundsOf (&boxes[0], &mats[0], n), expected, e));
+}
+
+void
+batchedBoxTransforms()
+{
+    cout << "  batched box transforms" << endl;
+
+    Rand48 rand (0);
+
+    batchedBoxTransforms<float> (rand);
+    batchedBoxTransforms<double> (rand);
+}
+
+template <class T>
+void
+closestPointsOfMany (Rand48& rand)
+{
+    const size_t n = 300;
+
+    Box<Vec3<T>> box (Vec3<T> (1, 2, 3), Vec3<T> (5, 4, 6));
+
+    std::vector<T> x (n), y (n), z (n), qx (n), qy (n), qz (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = T (rand.nextf (0, 6));
+        y[i] = T (rand.nextf (1, 5));
+        z[i] = T (rand.nextf (2, 7));
+
+        //
+        // Include points on the faces, and equally close to two faces.
+        //
+
+        if (i % 7 == 0)
+            x[i] = box.max.x;
+
+        if (i % 11 == 0)
+            y[i] = (box.min.y + box.max.y) / 2, z[i] = box.min.z + T (1);
+    }
+
+    //
+    // Points on the box, in it and out of it, and in an empty box
+    //
+
+    closestPointOnBox (&x[0], &y[0], &z[0], n, box, &qx[0], &qy[0], &qz[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> q = closestPointOnBox (Vec3<T> (x[i], y[i], z[i]), box);
+        assert (qx[i] == q.x && qy[i] == q.y && qz[i] == q.z);
+    }
+
+    closestPointOnBox (&x[0], &y[0], &z[0], n, Box<Vec3<T>>(), &qx[0], &qy[0], &qz[0]);
+
+    assert (qx == x && qy == y && qz == z);
+
+    //
+    // The box nearest to a point, ignoring empty boxes
+    //
+
+    std::vector<Box<Vec3<T>>> boxes (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Vec3<T> c (rand.nextf (-20, 20), rand.nextf (-20, 20), rand.nextf (-20, 20));
+        Vec3<T> s (rand.nextf (0, 2), rand.nextf (0, 2), rand.nextf (0, 2));
+        boxes[i] = Box<Vec3<T>> (c, c + s);
+
+        if (i % 13 == 0)
+            boxes[i].makeEmpty();
+    }
+
+    for (int q = 0; q < 100; ++q)
+    {
+        Vec3<T> p (rand.nextf (-25, 25), rand.nextf (-25, 25), rand.nextf (-25, 25));
+
+        int expected = -1;
+        T expectedD2 = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T d2 = (closestPointInBox (p, boxes[i]) - p).length2();
+
+            if (!boxes[i].isEmpty() && (expected < 0 || d2 < expectedD2))
+            {
+                expected   = int (i);
+                expectedD2 = d2;
+            }
+        }
+
+        Vec3<T> point;
+
+        assert (closestBox (p, &boxes[0], n, point) == expected);
+        assert (point == closestPointInBox (p, boxes[expected]));
+
+        //
+        // Of boxes that contain the point, the first is returned.
+        //
+
+        if (q % 10 == 0)
+        {
+            std::vector<Box<Vec3<T>>> containing (boxes);
+            containing[q + 100] = Box<Vec3<T>> (p);
+            containing[q + 200] = Box<Vec3<T>> (p - Vec3<T> (1), p + Vec3<T> (1));
+
+            assert (closestBox (p, &containing[0], n, point) == q + 100);
+            assert (point == p);
+        }
+    }
+
+    Vec3<T> point (7);
+
+    assert (closestBox (point, &boxes[0], 0, point) == -1);
+    assert (closestBox (point, &boxes[0], 1, point) == -1);
+    assert (point == Vec3<T> (7));
+}
+
+void
+closestPointsOfMany()
+{
+    cout << "  closest points of many points and boxes" << endl;
+
+    Rand48 rand (0);
+
+    closestPointsOfMany<float> (rand);
+    closestPointsOfMany<double> (rand);
+}
+
 } // namespace
 
 void
@@ -904,6 +1350,10 @@ testBoxAlgo()
     rayBoxIntersection2();
     boxMatrixTransform();
     pointInAndOnBox();
+    boundsOfPoints();
+    rayPackets();
+    batchedBoxTransforms();
+    closestPointsOfMany();
 
     cout << "ok\n" << endl;
 }
@@ -10,8 +10,10 @@
 #include <ImathColor.h>
 #include <ImathColorAlgo.h>
 #include <ImathMath.h>
+#include <ImathRandom.h>
 #include <assert.h>
 #include <iostream>
+#include <vector>
 #include "testColor.h"
 
 // Include ImathForward *after* other headers to validate forward declarations
@@ -19,6 +21,214 @@
 
 using namespace std;
 
+namespace
+{
+
+typedef IMATH_INTERNAL_NAMESPACE::C3f C3f;
+typedef IMATH_INTERNAL_NAMESPACE::C4f C4f;
+typedef IMATH_INTERNAL_NAMESPACE::C3h C3h;
+typedef IMATH_INTERNAL_NAMESPACE::C4h C4h;
+typedef IMATH_INTERNAL_NAMESPACE::half half;
+
+//
+// Compare two colors, channel by channel, within e relative to the
+// magnitude of the channel; the hue, if hue is set, wraps around at 1.
+//
+
+template <class C, class D>
+bool
+equalColors (const C& c, const D& d, float e, bool hue)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        float x    = c[i];
+        float y    = d[i];
+        float diff = std::fabs (x - y);
+
+        if (hue && i == 0)
+            diff = std::min (diff, std::fabs (1 - diff));
+
+        if (!(diff <= e * std::max (1.0f, std::fabs (x))))
+            return false;
+    }
+
+    return true;
+}
+
+void
+testBatchedHsv()
+{
+    cout << "batched rgb2hsv and hsv2rgb" << endl;
+
+    IMATH_INTERNAL_NAMESPACE::Rand48 rand (0);
+
+    //
+    // Random colors, and black, white, grays, primaries, ties for the
+    // largest channel, and colors with negative channels or channels
+    // greater than 1. The number of colors is not a multiple of 64.
+    //
+
+    std::vector<C3f> rgb = { C3f (0, 0, 0),
+                             C3f (1, 1, 1),
+                             C3f (0.5f, 0.5f, 0.5f),
+                             C3f (1, 0, 0),
+                             C3f (0, 1, 0),
+                             C3f (0, 0, 1),
+                             C3f (1, 1, 0),
+                             C3f (0, 1, 1),
+                             C3f (1, 0, 1),
+                             C3f (0.2f, 0.7f, 0.7f),
+                             C3f (-0.5f, 0.2f, 0.1f),
+                             C3f (2, 0.5f, 0.25f),
+                             C3f (0, -0.5f, -1) };
+
+    //
+    // Random hsv colors, and hues of 1, and out of the range [0, 1],
+    // which are converted to black.
+    //
+
+    std::vector<C3f> hsv = { C3f (0, 0.5f, 0.5f),
+                             C3f (1, 0.5f, 0.5f),
+                             C3f (1, 1, 1),
+                             C3f (0, 0, 1),
+                             C3f (1.5f, 0.5f, 1),
+                             C3f (-0.25f, 1, 1),
+                             C3f (0.5f, 0, 0.7f),
+                             C3f (0.999999f, 1, 1) };
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        rgb.push_back (C3f (rand.nextf (0, 1), rand.nextf (0, 1), rand.nextf (0, 1)));
+        hsv.push_back (C3f (rand.nextf (0, 1), rand.nextf (0, 1), rand.nextf (0, 1)));
+    }
+
+    const float e  = 1e-6f;
+    const float eh = 2e-3f;
+
+    size_t n = rgb.size();
+    size_t m = hsv.size();
+
+    //
+    // Interleaved float colors agree with the scalar conversions.
+    //
+
+    std::vector<C3f> result (n);
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&rgb[0], n, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equalColors (result[i], IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgb[i]), e, true));
+
+    std::vector<C3f> back (n);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&result[0], n, &back[0]);
+
+    //
+    // Colors whose largest channel is not positive convert to black.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equalColors (back[i], result[i].z > 0 ? rgb[i] : C3f (0), 1e-5f, false));
+
+    std::vector<C3f> hsvResult (m);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&hsv[0], m, &hsvResult[0]);
+
+    for (size_t i = 0; i < m; ++i)
+        assert (equalColors (hsvResult[i], IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsv[i]), e, false));
+
+    assert (hsvResult[4] == C3f (0) && hsvResult[5] == C3f (0));
+
+    //
+    // Colors with alpha, planar channels, and conversions in place
+    // give the same results.
+    //
+
+    std::vector<C4f> rgba (n), hsva (n);
+
+    for (size_t i = 0; i < n; ++i)
+        rgba[i] = C4f (rgb[i].x, rgb[i].y, rgb[i].z, float (i));
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&rgba[0], n, &hsva[0]);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&hsva[0], n, &hsva[0]);
+
+    std::vector<float> r (n), g (n), b (n), h (n), s (n), v (n);
+
+    for (size_t i = 0; i < n; ++i)
+        r[i] = rgb[i].x, g[i] = rgb[i].y, b[i] = rgb[i].z;
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&r[0], &g[0], &b[0], n, &h[0], &s[0], &v[0]);
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&r[0], &g[0], &b[0], n, &r[0], &g[0], &b[0]);
+
+    std::vector<C3f> inPlace = rgb;
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&inPlace[0], n, &inPlace[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (C3f (h[i], s[i], v[i]) == result[i]);
+        assert (C3f (r[i], g[i], b[i]) == result[i]);
+        assert (inPlace[i] == result[i]);
+        assert (C3f (hsva[i].r, hsva[i].g, hsva[i].b) == back[i] && hsva[i].a == float (i));
+    }
+
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&h[0], &s[0], &v[0], n, &h[0], &s[0], &v[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (C3f (h[i], s[i], v[i]) == back[i]);
+
+    //
+    // Half colors agree with the scalar conversions to within the
+    // precision of half.
+    //
+
+    std::vector<C3h> rgbh (n), hsvh (n);
+    std::vector<C4h> rgbah (n), hsvah (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        rgbh[i]  = C3h (half (rgb[i].x), half (rgb[i].y), half (rgb[i].z));
+        rgbah[i] = C4h (rgbh[i].x, rgbh[i].y, rgbh[i].z, half (float (i % 7)));
+    }
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&rgbh[0], n, &hsvh[0]);
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&rgbah[0], n, &hsvah[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (equalColors (hsvh[i], IMATH_INTERNAL_NAMESPACE::rgb2hsv (rgbh[i]), eh, true));
+        assert (C3h (hsvah[i].r, hsvah[i].g, hsvah[i].b) == hsvh[i]);
+        assert (hsvah[i].a == rgbah[i].a);
+    }
+
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&hsvh[0], n, &rgbh[0]);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&hsvah[0], n, &hsvah[0]);
+
+    std::vector<half> hh (n), sh (n), vh (n);
+
+    for (size_t i = 0; i < n; ++i)
+        hh[i] = hsvh[i].x, sh[i] = hsvh[i].y, vh[i] = hsvh[i].z;
+
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb (&hh[0], &sh[0], &vh[0], n, &hh[0], &sh[0], &vh[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (equalColors (rgbh[i], IMATH_INTERNAL_NAMESPACE::hsv2rgb (hsvh[i]), eh, false));
+        assert (C3h (hsvah[i].r, hsvah[i].g, hsvah[i].b) == rgbh[i]);
+        assert (C3h (hh[i], sh[i], vh[i]) == rgbh[i]);
+    }
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv (&hh[0], &sh[0], &vh[0], n, &hh[0], &sh[0], &vh[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equalColors (C3h (hh[i], sh[i], vh[i]), hsvh[i], eh, true));
+
+    //
+    // Empty arrays
+    //
+
+    IMATH_INTERNAL_NAMESPACE::rgb2hsv ((const C3f*) nullptr, 0, (C3f*) nullptr);
+    IMATH_INTERNAL_NAMESPACE::hsv2rgb ((const C4h*) nullptr, 0, (C4h*) nullptr);
+}
+
+} // namespace
+
 void
 testColor()
 {
@@ -162,5 +372,7 @@ testColor()
             std::fabs ((X.b / Y.b) - tmp.b) <= 1e-5f &&
             std::fabs ((X.a / Y.a) - tmp.a) <= 1e-5f);
 
+    testBatchedHsv();
+
     cout << "ok\n" << endl;
 }
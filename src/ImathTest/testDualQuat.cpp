@@ -0,0 +1,243 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathDualQuat.h>
+#include <ImathRandom.h>
+#include <assert.h>
+#include <iostream>
+#include <math.h>
+#include <vector>
+#include "testDualQuat.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+DualQuatd
+randomRigid (Rand48& rand)
+{
+    Quatd q;
+    q.setAxisAngle (hollowSphereRand<V3d> (rand), rand.nextf (-M_PI, M_PI));
+
+    V3d t (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+    return DualQuatd (q, t);
+}
+
+void
+testConversions()
+{
+    cout << "  conversions" << endl;
+
+    Rand48 rand (29);
+    double e = 1e-12;
+
+    assert (DualQuatd().toMatrix44() == M44d());
+    assert (DualQuatd::identity() == DualQuatd());
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        Quatd q;
+        q.setAxisAngle (hollowSphereRand<V3d> (rand), rand.nextf (-M_PI, M_PI));
+
+        V3d t (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+        //
+        // Rotation and translation round trip.
+        //
+
+        DualQuatd dq (q, t);
+
+        assert (dq.rotation() == q);
+        assert (dq.translation().equalWithAbsError (t, e));
+
+        //
+        // The matrix rotates, then translates.
+        //
+
+        M44d m = q.toMatrix44();
+        m[3][0] = t.x;
+        m[3][1] = t.y;
+        m[3][2] = t.z;
+
+        assert (dq.toMatrix44().equalWithAbsError (m, e));
+
+        //
+        // Constructing from the matrix yields the same transformation,
+        // up to the sign of the quaternions.
+        //
+
+        DualQuatd fromMatrix (m);
+
+        assert (fromMatrix.toMatrix44().equalWithAbsError (m, 1e-10));
+
+        //
+        // Points and directions.
+        //
+
+        V3d p (rand.nextf (-5, 5), rand.nextf (-5, 5), rand.nextf (-5, 5));
+
+        assert (dq.transformPoint (p).equalWithAbsError (p * m, e));
+
+        V3d v;
+        m.multDirMatrix (p, v);
+        assert (dq.transformDirection (p).equalWithAbsError (v, e));
+
+        //
+        // Scaling is removed by the matrix constructor.
+        //
+
+        M44d ms = m;
+        ms.scale (V3d (2, 3, 4));
+        assert (DualQuatd (ms).toMatrix44().equalWithAbsError (m, 1e-10));
+    }
+}
+
+void
+testAlgebra()
+{
+    cout << "  composition and inverse" << endl;
+
+    Rand48 rand (31);
+    double e = 1e-10;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        DualQuatd a = randomRigid (rand);
+        DualQuatd b = randomRigid (rand);
+
+        //
+        // a * b applies b first.
+        //
+
+        DualQuatd ab = a * b;
+        assert (ab.toMatrix44().equalWithAbsError (b.toMatrix44() * a.toMatrix44(), e));
+
+        DualQuatd c = a;
+        c *= b;
+        assert (c == ab);
+
+        //
+        // The inverse undoes the transformation.
+        //
+
+        V3d p (rand.nextf (-5, 5), rand.nextf (-5, 5), rand.nextf (-5, 5));
+        assert (a.inverse().transformPoint (a.transformPoint (p)).equalWithAbsError (p, e));
+        assert ((a * a.inverse()).toMatrix44().equalWithAbsError (M44d(), e));
+
+        //
+        // Negation and scaling represent the same transformation.
+        //
+
+        assert ((-a).toMatrix44().equalWithAbsError (a.toMatrix44(), e));
+        assert ((a * 3.0).normalized().toMatrix44().equalWithAbsError (a.toMatrix44(), e));
+    }
+}
+
+void
+testSkinning()
+{
+    cout << "  skinning" << endl;
+
+    Rand48 rand (37);
+
+    const int numBones = 20;
+    const size_t numInfluences = 4;
+    const size_t n = 1000;
+
+    std::vector<DualQuatd> bones (numBones);
+    for (int i = 0; i < numBones; ++i)
+        bones[i] = randomRigid (rand);
+
+    //
+    // Randomly flip some of the bones: the blend must not depend on
+    // the sign of the quaternions.
+    //
+
+    std::vector<DualQuatd> flipped (bones);
+    for (int i = 0; i < numBones; i += 3)
+        flipped[i] = -flipped[i];
+
+    std::vector<int> indices (n * numInfluences);
+    std::vector<double> weights (n * numInfluences);
+    std::vector<V3d> points (n), normals (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        double sum = 0;
+
+        for (size_t j = 0; j < numInfluences; ++j)
+        {
+            indices[i * numInfluences + j] = rand.nexti() % numBones;
+            weights[i * numInfluences + j] = rand.nextf (0, 1);
+            sum += weights[i * numInfluences + j];
+        }
+
+        for (size_t j = 0; j < numInfluences; ++j)
+            weights[i * numInfluences + j] /= sum;
+
+        points[i]  = V3d (rand.nextf (-5, 5), rand.nextf (-5, 5), rand.nextf (-5, 5));
+        normals[i] = hollowSphereRand<V3d> (rand);
+    }
+
+    //
+    // A single influence with full weight reproduces the bone.
+    //
+
+    std::vector<int> single (n);
+    std::vector<double> one (n, 1.0);
+    std::vector<V3d> result (n), resultNormals (n), resultFlipped (n);
+
+    for (size_t i = 0; i < n; ++i)
+        single[i] = int (i % numBones);
+
+    skinDualQuat (&bones[0], &single[0], &one[0], 1, &points[0], n, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (result[i].equalWithAbsError (bones[i % numBones].transformPoint (points[i]), 1e-10));
+
+    //
+    // Blended skinning matches blendDualQuats() point by point, and
+    // rigidly transforms the normals.
+    //
+
+    skinDualQuat (&bones[0], &indices[0], &weights[0], numInfluences, &points[0], n, &result[0],
+                  &normals[0], &resultNormals[0]);
+
+    skinDualQuat (&flipped[0], &indices[0], &weights[0], numInfluences, &points[0], n,
+                  &resultFlipped[0]);
+
+    std::vector<DualQuatd> blend (n);
+    blendDualQuats (&bones[0], &indices[0], &weights[0], numInfluences, n, &blend[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (equalWithAbsError (blend[i].r.length(), 1.0, 1e-12));
+        assert (result[i].equalWithAbsError (blend[i].transformPoint (points[i]), 1e-10));
+        assert (resultFlipped[i].equalWithAbsError (result[i], 1e-10));
+        assert (resultNormals[i].equalWithAbsError (blend[i].transformDirection (normals[i]), 1e-10));
+        assert (equalWithAbsError (resultNormals[i].length(), 1.0, 1e-10));
+    }
+}
+
+} // namespace
+
+void
+testDualQuat()
+{
+    cout << "Testing dual quaternions" << endl;
+
+    testConversions();
+    testAlgebra();
+    testSkinning();
+
+    cout << "ok\n" << endl;
+}
@@ -13,6 +13,7 @@
 #include <ImathRandom.h>
 #include <assert.h>
 #include <iostream>
+#include <vector>
 #include "testExtractEuler.h"
 
 using namespace std;
@@ -193,6 +194,176 @@ testRandomAngles33()
     }
 }
 
+template <int Order>
+void
+testStaticOrder()
+{
+    //
+    // The conversions with a compile-time order match
+    // those of an Euler with the same order.
+    //
+
+    Rand48 r (Order);
+
+    const int n = 100;
+    V3f angles[n];
+    M44f matrices[n];
+    Quatf quats[n];
+    V3f extracted[n];
+
+    for (int i = 0; i < n; ++i)
+        angles[i] = V3f (rad (r.nextf (-180, 180)), rad (r.nextf (-180, 180)), rad (r.nextf (-180, 180)));
+
+    eulerToMatrix44<Order> (angles, n, matrices);
+    eulerToQuat<Order> (angles, n, quats);
+    eulerFromMatrix<Order> (matrices, n, extracted);
+
+    const Eulerf::Order order = Eulerf::Order (Order);
+    float e                   = 1e-6;
+
+    for (int i = 0; i < n; ++i)
+    {
+        Eulerf f (angles[i], order);
+
+        assert (eulerToMatrix33<Order> (angles[i]).equalWithAbsError (f.toMatrix33(), e));
+        assert (eulerToMatrix44<Order> (angles[i]).equalWithAbsError (f.toMatrix44(), e));
+        assert (matrices[i].equalWithAbsError (f.toMatrix44(), e));
+
+        Quatf q = f.toQuat();
+        assert (equalWithAbsError (quats[i].r, q.r, e));
+        assert (quats[i].v.equalWithAbsError (q.v, e));
+
+        Eulerf g (order);
+        g.extract (matrices[i]);
+        assert (extracted[i].equalWithAbsError (g, e));
+        assert (eulerFromMatrix<Order> (f.toMatrix33()).equalWithAbsError (g, e));
+    }
+}
+
+void
+testStaticOrders()
+{
+    testStaticOrder<Eulerf::XYZ>();
+    testStaticOrder<Eulerf::XZY>();
+    testStaticOrder<Eulerf::YZX>();
+    testStaticOrder<Eulerf::YXZ>();
+    testStaticOrder<Eulerf::ZXY>();
+    testStaticOrder<Eulerf::ZYX>();
+
+    testStaticOrder<Eulerf::XZX>();
+    testStaticOrder<Eulerf::XYX>();
+    testStaticOrder<Eulerf::YXY>();
+    testStaticOrder<Eulerf::YZY>();
+    testStaticOrder<Eulerf::ZYZ>();
+    testStaticOrder<Eulerf::ZXZ>();
+
+    testStaticOrder<Eulerf::XYZr>();
+    testStaticOrder<Eulerf::XZYr>();
+    testStaticOrder<Eulerf::YZXr>();
+    testStaticOrder<Eulerf::YXZr>();
+    testStaticOrder<Eulerf::ZXYr>();
+    testStaticOrder<Eulerf::ZYXr>();
+
+    testStaticOrder<Eulerf::XZXr>();
+    testStaticOrder<Eulerf::XYXr>();
+    testStaticOrder<Eulerf::YXYr>();
+    testStaticOrder<Eulerf::YZYr>();
+    testStaticOrder<Eulerf::ZYZr>();
+    testStaticOrder<Eulerf::ZXZr>();
+}
+
+void
+testUnwrap (Eulerf::Order order)
+{
+    //
+    // Random, smooth rotation curves. The Euler angles extracted
+    // from the matrices jump by 2*PI or flip; unwrapping them makes
+    // consecutive samples near each other again without changing
+    // the rotations.
+    //
+
+    Rand48 r (order);
+
+    const size_t numCurves  = 37;
+    const size_t numSamples = 200;
+    const float step        = 0.05;
+
+    std::vector<Eulerf> samples (numCurves * numSamples);
+    std::vector<M44f> matrices (numCurves * numSamples);
+
+    for (size_t c = 0; c < numCurves; ++c)
+    {
+        V3f a (r.nextf (-M_PI, M_PI), r.nextf (-M_PI, M_PI), r.nextf (-M_PI, M_PI));
+
+        for (size_t s = 0; s < numSamples; ++s)
+        {
+            a += V3f (r.nextf (-step, step), r.nextf (-step, step), r.nextf (-step, step));
+
+            size_t i    = s * numCurves + c;
+            matrices[i] = Eulerf (a, order, Eulerf::XYZLayout).toMatrix44();
+            samples[i]  = Eulerf (matrices[i], order);
+        }
+    }
+
+    std::vector<float> x (numCurves * numSamples);
+    std::vector<float> y (numCurves * numSamples);
+    std::vector<float> z (numCurves * numSamples);
+
+    for (size_t i = 0; i < numCurves * numSamples; ++i)
+    {
+        V3f v = samples[i].toXYZVector();
+        x[i]  = v.x;
+        y[i]  = v.y;
+        z[i]  = v.z;
+    }
+
+    //
+    // Unwrap the curves, the first ten separately from the rest.
+    //
+
+    unwrapEulerCurves (order, &x[0], &y[0], &z[0], 10, numSamples, numCurves);
+    unwrapEulerCurves (order, &x[10], &y[10], &z[10], numCurves - 10, numSamples, numCurves);
+
+    for (size_t c = 0; c < numCurves; ++c)
+    {
+        std::vector<Eulerf> curve (numSamples);
+
+        for (size_t s = 0; s < numSamples; ++s)
+            curve[s] = samples[s * numCurves + c];
+
+        unwrapEulerCurve (&curve[0], numSamples);
+
+        for (size_t s = 0; s < numSamples; ++s)
+        {
+            size_t i = s * numCurves + c;
+            V3f v    = curve[s].toXYZVector();
+
+            assert (curve[s].toMatrix44().equalWithAbsError (matrices[i], 1e-5));
+            assert (v.equalWithAbsError (V3f (x[i], y[i], z[i]), 1e-4));
+
+            if (s > 0)
+            {
+                V3f d = v - curve[s - 1].toXYZVector();
+                assert (d.dot (d) < 3 * (3 * step) * (3 * step));
+            }
+        }
+    }
+}
+
+void
+testUnwrap()
+{
+    testUnwrap (Eulerf::XYZ);
+    testUnwrap (Eulerf::XZY);
+    testUnwrap (Eulerf::YZX);
+    testUnwrap (Eulerf::YXZ);
+    testUnwrap (Eulerf::ZXY);
+    testUnwrap (Eulerf::ZYX);
+
+    testUnwrap (Eulerf::XYZr);
+    testUnwrap (Eulerf::ZYXr);
+}
+
 } // namespace
 
 void
@@ -238,5 +409,11 @@ testExtractEuler()
     test (matrixEulerMatrix_2, Eulerf::ZYZr);
     test (matrixEulerMatrix_2, Eulerf::ZXZr);
 
+    cout << "Euler conversions with a compile-time order" << endl;
+    testStaticOrders();
+
+    cout << "Unwrapping Euler angle curves" << endl;
+    testUnwrap();
+
     cout << "ok\n" << endl;
 }
@@ -15,6 +15,7 @@
 #include <exception>
 #include <iostream>
 #include <stdio.h>
+#include <vector>
 #include "testExtractSHRT.h"
 
 #if 0
@@ -247,6 +248,116 @@ testMatrix (const M44f M)
             }
         }
     }
+
+    //
+    // Repeat with the rotation extracted as a quaternion, and
+    // with an interpolator whose keys are both M.
+    //
+
+    Quatf q;
+
+    extractSHRT (M, s, h, q, t, true);
+
+    N.makeIdentity();
+    N.translate (t);
+    N = q.toMatrix44() * N;
+    N.shear (h);
+    N.scale (s);
+
+    assert (N.equalWithAbsError (M, 0.00001));
+
+    SHRTInterpolator<float> interp (M, M);
+
+    assert (interp.interpolate (0.0f).equalWithAbsError (M, 0.00001));
+    assert (interp.interpolate (0.3f).equalWithAbsError (M, 0.00001));
+    assert (interp.interpolate (1.0f).equalWithAbsError (M, 0.00001));
+}
+
+M44f
+randomMatrix (Rand48& random)
+{
+    M44f M;
+
+    M.translate (V3f (random.nextf (-10, 10), random.nextf (-10, 10), random.nextf (-10, 10)));
+    M.rotate (V3f (rad (random.nextf (-180, 180)),
+                   rad (random.nextf (-180, 180)),
+                   rad (random.nextf (-180, 180))));
+    M.shear (V3f (random.nextf (-1, 1), random.nextf (-1, 1), random.nextf (-1, 1)));
+    M.scale (V3f (random.nextf (0.1, 2.0), random.nextf (0.1, 2.0), random.nextf (0.1, 2.0)));
+
+    return M;
+}
+
+void
+testInterpolator()
+{
+    Rand48 random (0);
+
+    const size_t n = 1000;
+    const float times[] = { 0.0f, 0.25f, 0.5f, 0.75f, 1.0f };
+    const size_t numTimes = sizeof (times) / sizeof (times[0]);
+
+    std::vector<SHRTInterpolator<float>> interps (n);
+    std::vector<M44f> keys0 (n), keys1 (n), result (n * numTimes);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        keys0[i] = randomMatrix (random);
+        keys1[i] = randomMatrix (random);
+        assert (interps[i].setKeys (keys0[i], keys1[i]));
+    }
+
+    interpolateSHRT (&interps[0], n, times, numTimes, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        const SHRTInterpolator<float>& interp = interps[i];
+
+        //
+        // The end points reproduce the keys.
+        //
+
+        assert (result[i].equalWithAbsError (keys0[i], 0.0001));
+        assert (result[(numTimes - 1) * n + i].equalWithAbsError (keys1[i], 0.0001));
+
+        for (size_t j = 0; j < numTimes; ++j)
+        {
+            float t = times[j];
+
+            //
+            // The batched evaluation matches the single evaluation,
+            // and the rotation matches slerpShortestArc().
+            //
+
+            assert (result[j * n + i].equalWithAbsError (interp.interpolate (t), 1e-6));
+
+            M44f R (sansScalingAndShear (result[j * n + i]));
+            R[3][0] = R[3][1] = R[3][2] = 0;
+
+            Quatf q = slerpShortestArc (interp.r0, interp.r1, t);
+            assert (R.equalWithAbsError (q.toMatrix44(), 0.0001));
+
+            V3f p = result[j * n + i].translation();
+            assert (p.equalWithAbsError ((1 - t) * interp.t0 + t * interp.t1, 0.0001));
+        }
+    }
+
+    //
+    // A degenerate key, without exceptions, leaves the identity.
+    //
+
+    M44f degenerate;
+    degenerate.scale (V3f (1, 0, 1));
+
+    SHRTInterpolator<float> invalid (keys0[0], degenerate, false);
+
+    for (size_t j = 0; j < numTimes; ++j)
+        assert (invalid.interpolate (times[j]) == M44f());
+
+    SHRTInterpolator<float> reset (keys0[0], keys1[0]);
+
+    assert (!reset.setKeys (degenerate, keys1[0], false));
+    assert (reset.interpolate (0.5f) == M44f());
 }
 
 void
@@ -383,6 +494,9 @@ test()
         for (int j = 0; j < 360; j += 90)
             for (int k = 0; k < 360; k += 90)
                 testAngles44 (V3f (i, j, k));
+
+    cout << "  interpolation" << endl;
+    testInterpolator();
 }
 
 } // namespace
@@ -11,8 +11,10 @@
 #include <ImathFrustum.h>
 #include <ImathFun.h>
 #include <ImathVec.h>
+#include <algorithm>
 #include <assert.h>
 #include <iostream>
+#include <vector>
 #include "testFrustum.h"
 
 // Include ImathForward *after* other headers to validate forward declarations
@@ -150,6 +152,97 @@ testFrustumPlanes (IMATH_INTERNAL_NAMESPACE::Frustumf& frustum)
     }
 }
 
+bool
+closeTo (float a, float b)
+{
+    return IMATH_INTERNAL_NAMESPACE::abs<float> (a - b) <=
+           1e-5f * std::max (1.0f, IMATH_INTERNAL_NAMESPACE::abs<float> (b));
+}
+
+void
+testBatchedProjection (const IMATH_INTERNAL_NAMESPACE::Frustumf& frustum)
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    //
+    // Points in front of, on and behind the camera, including points
+    // at depth 0, projected to the screen and back to rays.
+    //
+
+    const size_t n = 101;
+
+    std::vector<float> x (n), y (n), z (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        x[i] = float (i % 7) - 3.5f;
+        y[i] = float (i % 5) * 0.7f - 1.2f;
+        z[i] = i % 10 == 0 ? 0.0f : -float (i) * 5.0f + 20.0f;
+    }
+
+    std::vector<float> screenX (n), screenY (n), normalizedZ (n);
+
+    frustum.projectPointToScreen (&x[0], &y[0], &z[0], n, &screenX[0], &screenY[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V2f s = frustum.projectPointToScreen (V3f (x[i], y[i], z[i]));
+        assert (closeTo (screenX[i], s.x) && closeTo (screenY[i], s.y));
+    }
+
+    std::fill (screenX.begin(), screenX.end(), 0.0f);
+    frustum.projectPointToScreen (&x[0], &y[0], &z[0], n, &screenX[0], &screenY[0], &normalizedZ[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V2f s = frustum.projectPointToScreen (V3f (x[i], y[i], z[i]));
+        assert (closeTo (screenX[i], s.x));
+
+        //
+        // The normalized z is compared with its value computed in
+        // double precision, since the depth it maps back to is
+        // ill-conditioned far from the camera.
+        //
+
+        double nearPlane = frustum.nearPlane();
+        double farPlane  = frustum.farPlane();
+        double expected  = frustum.orthographic()
+                               ? -(z[i] + nearPlane) / (farPlane - nearPlane)
+                               : farPlane / (farPlane - nearPlane) +
+                                     farPlane * nearPlane / ((farPlane - nearPlane) * z[i]);
+
+        if (z[i] != 0)
+            assert (closeTo (normalizedZ[i], float (expected)));
+    }
+
+    //
+    // The near and far planes map to 0 and 1.
+    //
+
+    float depths[2] = { -frustum.nearPlane(), -frustum.farPlane() };
+    float zeros[2]  = { 0, 0 };
+    float sx[2], sy[2], nz[2];
+
+    frustum.projectPointToScreen (zeros, zeros, depths, 2, sx, sy, nz);
+    assert (IMATH_INTERNAL_NAMESPACE::abs<float> (nz[0]) < 1e-6f);
+    assert (IMATH_INTERNAL_NAMESPACE::abs<float> (nz[1] - 1) < 1e-6f);
+
+    std::vector<float> posX (n), posY (n), posZ (n), dirX (n), dirY (n), dirZ (n);
+
+    frustum.projectScreenToRay (
+        &screenX[0], &screenY[0], n, &posX[0], &posY[0], &posZ[0], &dirX[0], &dirY[0], &dirZ[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Line3f ray = frustum.projectScreenToRay (V2f (screenX[i], screenY[i]));
+
+        assert (closeTo (posX[i], ray.pos.x) && closeTo (posY[i], ray.pos.y) &&
+                closeTo (posZ[i], ray.pos.z));
+        assert (closeTo (dirX[i], ray.dir.x) && closeTo (dirY[i], ray.dir.y) &&
+                closeTo (dirZ[i], ray.dir.z));
+    }
+}
+
 } // namespace
 
 void
@@ -335,5 +428,11 @@ testFrustum()
 
     cout << "\npassed noexcept equality verification";
 
+    testBatchedProjection (IMATH_INTERNAL_NAMESPACE::Frustumf (n, f, l, r, t, b, false));
+    testBatchedProjection (IMATH_INTERNAL_NAMESPACE::Frustumf (n, f, l, r, t, b, true));
+    testBatchedProjection (IMATH_INTERNAL_NAMESPACE::Frustumf (0.1f, 1000.0f, 0.7f, 0.0f, 1.5f));
+
+    cout << "\npassed batched projection";
+
     cout << "\nok\n\n";
 }
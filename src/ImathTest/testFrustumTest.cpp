@@ -10,9 +10,11 @@
 #include <ImathBox.h>
 #include <ImathFrustum.h>
 #include <ImathFrustumTest.h>
+#include <ImathRandom.h>
 #include <ImathSphere.h>
 #include <assert.h>
 #include <iostream>
+#include <vector>
 #include "testFrustumTest.h"
 
 // Include ImathForward *after* other headers to validate forward declarations
@@ -20,6 +22,280 @@
 
 using namespace std;
 
+namespace
+{
+
+template <class T>
+void
+testBatchedBoxes()
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    Frustum<T> frustum (T (0.5), T (50), T (-2), T (3), T (1.5), T (-1), false);
+
+    Matrix44<T> cameraMat;
+    cameraMat.setEulerAngles (Vec3<T> (T (0.3), T (-0.7), T (1.1)));
+    cameraMat.translate (Vec3<T> (1, 2, 3));
+
+    FrustumTest<T> frustumTest (frustum, cameraMat);
+    Rand48 rand (0);
+
+    //
+    // Sizes around the block size, and boxes of all sizes, including
+    // empty and flat boxes, scattered around the frustum.
+    //
+
+    const size_t sizes[] = { 0, 1, 5, 63, 64, 65, 128, 300 };
+
+    for (size_t n : sizes)
+    {
+        std::vector<T> minX (n), minY (n), minZ (n), maxX (n), maxY (n), maxZ (n);
+        std::vector<Box<Vec3<T>>> boxes (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> c (rand.nextf (-20, 20), rand.nextf (-20, 20), rand.nextf (-60, 5));
+            c = c * cameraMat;
+            Vec3<T> s (rand.nextf (0, 8), rand.nextf (0, 8), rand.nextf (0, 8));
+
+            if (i % 7 == 3)
+                s.y = 0;
+
+            boxes[i] = i % 11 == 5 ? Box<Vec3<T>>() : Box<Vec3<T>> (c - s, c + s);
+
+            minX[i] = boxes[i].min.x, minY[i] = boxes[i].min.y, minZ[i] = boxes[i].min.z;
+            maxX[i] = boxes[i].max.x, maxY[i] = boxes[i].max.y, maxZ[i] = boxes[i].max.z;
+        }
+
+        std::vector<uint64_t> visible ((n + 63) / 64 + 1, ~uint64_t (0));
+        std::vector<uint64_t> contained ((n + 63) / 64 + 1, ~uint64_t (0));
+
+        size_t numVisible = frustumTest.isVisible (
+            minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), n, &visible[0]);
+        size_t numContained = frustumTest.completelyContains (
+            minX.data(), minY.data(), minZ.data(), maxX.data(), maxY.data(), maxZ.data(), n, &contained[0]);
+
+        size_t expectedVisible = 0, expectedContained = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool v = frustumTest.isVisible (boxes[i]);
+            bool c = frustumTest.completelyContains (boxes[i]);
+
+            assert (((visible[i / 64] >> (i % 64)) & 1) == v);
+            assert (((contained[i / 64] >> (i % 64)) & 1) == c);
+
+            expectedVisible += v;
+            expectedContained += c;
+        }
+
+        assert (numVisible == expectedVisible);
+        assert (numContained == expectedContained);
+
+        //
+        // Unused bits are cleared, and nothing is written past the
+        // last word.
+        //
+
+        if (n % 64)
+        {
+            assert ((visible[n / 64] >> (n % 64)) == 0);
+            assert ((contained[n / 64] >> (n % 64)) == 0);
+        }
+
+        assert (visible[(n + 63) / 64] == ~uint64_t (0));
+        assert (contained[(n + 63) / 64] == ~uint64_t (0));
+    }
+}
+
+template <class T>
+void
+testBatchedSpheres()
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    Frustum<T> frustum (T (0.5), T (50), T (-2), T (3), T (1.5), T (-1), false);
+
+    Matrix44<T> cameraMat;
+    cameraMat.setEulerAngles (Vec3<T> (T (0.6), T (0.2), T (-1.3)));
+    cameraMat.translate (Vec3<T> (3, -2, 1));
+
+    FrustumTest<T> frustumTest (frustum, cameraMat);
+    Rand48 rand (2);
+
+    const size_t sizes[] = { 0, 1, 5, 63, 64, 65, 128, 300 };
+
+    for (size_t n : sizes)
+    {
+        std::vector<T> centerX (n), centerY (n), centerZ (n), radius (n);
+        std::vector<Sphere3<T>> spheres (n);
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> c (rand.nextf (-20, 20), rand.nextf (-20, 20), rand.nextf (-60, 5));
+            c = c * cameraMat;
+
+            spheres[i] = Sphere3<T> (c, i % 9 == 4 ? T (0) : T (rand.nextf (0, 8)));
+
+            centerX[i] = c.x, centerY[i] = c.y, centerZ[i] = c.z;
+            radius[i]  = spheres[i].radius;
+        }
+
+        const size_t words = (n + 63) / 64;
+
+        std::vector<uint64_t> visible (words + 1, ~uint64_t (0));
+        std::vector<uint64_t> contained (words + 1, ~uint64_t (0));
+        std::vector<uint64_t> classVisible (words + 1, ~uint64_t (0));
+        std::vector<uint64_t> classContained (words + 1, ~uint64_t (0));
+
+        size_t numVisible = frustumTest.isVisible (
+            centerX.data(), centerY.data(), centerZ.data(), radius.data(), n, &visible[0]);
+        size_t numContained = frustumTest.completelyContains (
+            centerX.data(), centerY.data(), centerZ.data(), radius.data(), n, &contained[0]);
+        size_t numClassVisible = frustumTest.classify (centerX.data(),
+                                                       centerY.data(),
+                                                       centerZ.data(),
+                                                       radius.data(),
+                                                       n,
+                                                       &classVisible[0],
+                                                       &classContained[0]);
+
+        size_t expectedVisible = 0, expectedContained = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool v = frustumTest.isVisible (spheres[i]);
+            bool c = frustumTest.completelyContains (spheres[i]);
+
+            assert (((visible[i / 64] >> (i % 64)) & 1) == v);
+            assert (((contained[i / 64] >> (i % 64)) & 1) == c);
+
+            expectedVisible += v;
+            expectedContained += c;
+        }
+
+        assert (numVisible == expectedVisible);
+        assert (numContained == expectedContained);
+        assert (numClassVisible == expectedVisible);
+
+        //
+        // The classification agrees with the separate tests, and
+        // contained spheres are visible. Unused bits are cleared, and
+        // nothing is written past the last word.
+        //
+
+        for (size_t w = 0; w < words; ++w)
+        {
+            assert (classVisible[w] == visible[w]);
+            assert (classContained[w] == contained[w]);
+            assert ((contained[w] & ~visible[w]) == 0);
+        }
+
+        if (n % 64)
+            assert ((classVisible[n / 64] >> (n % 64)) == 0);
+
+        assert (visible[words] == ~uint64_t (0));
+        assert (contained[words] == ~uint64_t (0));
+        assert (classVisible[words] == ~uint64_t (0));
+        assert (classContained[words] == ~uint64_t (0));
+    }
+}
+
+template <class T>
+void
+testMaskedBoxes()
+{
+    using namespace IMATH_INTERNAL_NAMESPACE;
+
+    Frustum<T> frustum (T (0.5), T (50), T (-2), T (3), T (1.5), T (-1), false);
+
+    Matrix44<T> cameraMat;
+    cameraMat.setEulerAngles (Vec3<T> (T (-0.4), T (0.9), T (0.2)));
+    cameraMat.translate (Vec3<T> (-3, 1, 2));
+
+    FrustumTest<T> frustumTest (frustum, cameraMat);
+    Rand48 rand (1);
+
+    int lastPlane = 0;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        Vec3<T> c (rand.nextf (-20, 20), rand.nextf (-20, 20), rand.nextf (-60, 5));
+        c = c * cameraMat;
+        Vec3<T> s (rand.nextf (0, 8), rand.nextf (0, 8), rand.nextf (0, 8));
+
+        Box<Vec3<T>> box (c - s, c + s);
+
+        //
+        // With all planes active, the results are those of the
+        // unmasked tests, for any starting plane.
+        //
+
+        if (i % 100 == 0)
+            lastPlane = i / 100 % 8 - 1;
+
+        unsigned int planeMask = 0x3f;
+        int culledBy           = lastPlane;
+        bool visible           = frustumTest.isVisible (box, planeMask, culledBy);
+
+        assert (visible == frustumTest.isVisible (box));
+
+        if (!visible)
+        {
+            //
+            // The culling plane alone culls the box.
+            //
+
+            unsigned int mask = 1u << culledBy;
+            int p             = 0;
+
+            assert (!frustumTest.isVisible (box, mask, p));
+            assert (p == culledBy);
+
+            lastPlane = culledBy;
+            continue;
+        }
+
+        unsigned int containMask = 0x3f;
+        int p                    = lastPlane;
+        bool contained           = frustumTest.completelyContains (box, containMask, p);
+
+        assert (contained == frustumTest.completelyContains (box));
+        assert (contained == (planeMask == 0));
+        assert (!contained || containMask == 0);
+
+        //
+        // A box inside a visible box needs only be tested against
+        // the planes that the outer box straddles, and inactive
+        // planes are not tested.
+        //
+
+        Vec3<T> d (rand.nextf (0, 1), rand.nextf (0, 1), rand.nextf (0, 1));
+        Box<Vec3<T>> inner (c - s * d, c + s * d);
+
+        unsigned int innerMask = planeMask;
+        unsigned int allMask   = 0x3f;
+        int q                  = lastPlane;
+
+        assert (frustumTest.isVisible (inner, innerMask, q) == frustumTest.isVisible (inner, allMask, q));
+        assert ((innerMask & ~planeMask) == 0);
+
+        unsigned int noPlanes = 0;
+        assert (frustumTest.isVisible (inner, noPlanes, q) && noPlanes == 0);
+        assert (frustumTest.completelyContains (inner, noPlanes, q));
+    }
+
+    //
+    // Empty boxes are neither visible nor contained.
+    //
+
+    unsigned int planeMask = 0;
+    assert (!frustumTest.isVisible (Box<Vec3<T>>(), planeMask, lastPlane));
+    assert (!frustumTest.completelyContains (Box<Vec3<T>>(), planeMask, lastPlane));
+}
+
+} // namespace
+
 void
 testFrustumTest()
 {
@@ -146,5 +422,23 @@ testFrustumTest()
         IMATH_INTERNAL_NAMESPACE::Sphere3<float> (outsideVec_up, tinyRadius)));
     cout << "passed Sphere\n";
 
+    /////////////////////////////////////////////////////
+    // Test batches of boxes
+    testBatchedBoxes<float>();
+    testBatchedBoxes<double>();
+    cout << "passed batched Box\n";
+
+    /////////////////////////////////////////////////////
+    // Test batches of spheres
+    testBatchedSpheres<float>();
+    testBatchedSpheres<double>();
+    cout << "passed batched Sphere\n";
+
+    /////////////////////////////////////////////////////
+    // Test boxes against subsets of the planes
+    testMaskedBoxes<float>();
+    testMaskedBoxes<double>();
+    cout << "passed masked Box\n";
+
     cout << "\nok\n\n";
 }
@@ -11,6 +11,8 @@
 #include <ImathRandom.h>
 #include <assert.h>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include "testLineAlgo.h"
 
 // Include ImathForward *after* other headers to validate forward declarations
@@ -413,6 +415,358 @@ testIntersect()
     }
 }
 
+//
+// The hit of a ray, rather than a line, with a triangle, by the
+// single-triangle intersect(). Hits too close to the triangle's
+// edges or the ray's origin for Moller-Trumbore to be expected to
+// agree are flagged as ambiguous.
+//
+
+bool
+rayHit (const Line3f& ray,
+        const V3f& v0,
+        const V3f& v1,
+        const V3f& v2,
+        float& t,
+        V3f& bary,
+        bool& ambiguous)
+{
+    V3f pt;
+    bool front;
+
+    ambiguous = false;
+
+    if (!intersect (ray, v0, v1, v2, pt, bary, front))
+        return false;
+
+    t = (pt - ray.pos) ^ ray.dir;
+
+    const float margin = 1e-3f;
+    ambiguous          = bary.x < margin || bary.y < margin || bary.z < margin || abs (t) < margin;
+
+    return t >= 0;
+}
+
+void
+testPacketIntersect()
+{
+    cout << "intersections of packets of rays and triangles" << endl;
+
+    Rand48 rand (0);
+
+    const size_t n = 300;
+
+    std::vector<float> v0x (n), v0y (n), v0z (n), v1x (n), v1y (n), v1z (n), v2x (n), v2y (n), v2z (n);
+    std::vector<V3f> v0 (n), v1 (n), v2 (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3f c (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+        v0[i] = c + solidSphereRand<V3f> (rand) * 3;
+        v1[i] = c + solidSphereRand<V3f> (rand) * 3;
+        v2[i] = c + solidSphereRand<V3f> (rand) * 3;
+
+        v0x[i] = v0[i].x, v0y[i] = v0[i].y, v0z[i] = v0[i].z;
+        v1x[i] = v1[i].x, v1y[i] = v1[i].y, v1z[i] = v1[i].z;
+        v2x[i] = v2[i].x, v2y[i] = v2[i].y, v2z[i] = v2[i].z;
+    }
+
+    //
+    // One ray against many triangles
+    //
+
+    int numHits = 0;
+
+    for (int r = 0; r < 500; ++r)
+    {
+        V3f p (rand.nextf (-12, 12), rand.nextf (-12, 12), rand.nextf (-12, 12));
+        Line3f ray (p, p + hollowSphereRand<V3f> (rand));
+
+        int expected    = -1;
+        float expectedT = 0;
+        V3f expectedBary (0);
+        bool ambiguous = false;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            float t;
+            V3f bary (0);
+            bool amb;
+
+            bool hit = rayHit (ray, v0[i], v1[i], v2[i], t, bary, amb);
+            ambiguous |= amb;
+
+            if (hit && (expected < 0 || t < expectedT))
+            {
+                expected     = int (i);
+                expectedT    = t;
+                expectedBary = bary;
+            }
+        }
+
+        float t;
+        V3f bary (0);
+
+        int nearest = intersect (ray,
+                                 &v0x[0],
+                                 &v0y[0],
+                                 &v0z[0],
+                                 &v1x[0],
+                                 &v1y[0],
+                                 &v1z[0],
+                                 &v2x[0],
+                                 &v2y[0],
+                                 &v2z[0],
+                                 n,
+                                 t,
+                                 bary);
+
+        if (ambiguous)
+            continue;
+
+        assert (nearest == expected);
+
+        if (nearest >= 0)
+        {
+            ++numHits;
+            assert (equalWithAbsError (t, expectedT, 1e-4f));
+            assert (bary.equalWithAbsError (expectedBary, 1e-4f));
+
+            V3f pt = v0[nearest] * bary.x + v1[nearest] * bary.y + v2[nearest] * bary.z;
+            assert (pt.equalWithAbsError (ray (t), 1e-4f));
+        }
+    }
+
+    assert (numHits > 50);
+
+    //
+    // Many rays against one triangle, with unnormalized directions
+    //
+
+    std::vector<float> posX (n), posY (n), posZ (n), dirX (n), dirY (n), dirZ (n);
+    std::vector<float> t (n), u (n), v (n);
+    std::unique_ptr<bool[]> hits (new bool[n]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3f p (rand.nextf (-5, 5), rand.nextf (-5, 5), rand.nextf (-5, 5));
+        V3f d = hollowSphereRand<V3f> (rand) * rand.nextf (0.5, 2);
+
+        posX[i] = p.x, posY[i] = p.y, posZ[i] = p.z;
+        dirX[i] = d.x, dirY[i] = d.y, dirZ[i] = d.z;
+    }
+
+    for (int k = 0; k < 10; ++k)
+    {
+        size_t count = intersect (v0[k],
+                                  v1[k],
+                                  v2[k],
+                                  &posX[0],
+                                  &posY[0],
+                                  &posZ[0],
+                                  &dirX[0],
+                                  &dirY[0],
+                                  &dirZ[0],
+                                  n,
+                                  hits.get(),
+                                  &t[0],
+                                  &u[0],
+                                  &v[0]);
+
+        size_t expectedCount = 0;
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            V3f p (posX[i], posY[i], posZ[i]);
+            V3f d (dirX[i], dirY[i], dirZ[i]);
+            Line3f ray (p, p + d);
+
+            float expectedT;
+            V3f bary;
+            bool ambiguous;
+
+            bool hit = rayHit (ray, v0[k], v1[k], v2[k], expectedT, bary, ambiguous);
+            expectedCount += hits[i];
+
+            assert (hits[i] == (t[i] != std::numeric_limits<float>::infinity()));
+
+            if (ambiguous)
+                continue;
+
+            assert (hits[i] == hit);
+
+            if (hit)
+            {
+                assert (equalWithAbsError (t[i] * d.length(), expectedT, 1e-4f));
+                assert (equalWithAbsError (u[i], bary.y, 1e-4f));
+                assert (equalWithAbsError (v[i], bary.z, 1e-4f));
+            }
+        }
+
+        assert (count == expectedCount);
+    }
+
+    //
+    // Rays behind, and in the plane of, a triangle, and degenerate
+    // triangles miss. A ray starting on a triangle hits it at 0.
+    //
+
+    V3f a (0, 0, 0), b (1, 0, 0), c (0, 1, 0);
+
+    float px[4] = { 0.25f, 0.25f, -1, 0.25f };
+    float py[4] = { 0.25f, 0.25f, 0.25f, 0.25f };
+    float pz[4] = { 1, -1, 0, 0 };
+    float dx[4] = { 0, 0, 1, 0 };
+    float dy[4] = { 0, 0, 0, 0 };
+    float dz[4] = { -2, -1, 0, 1 };
+    bool hit4[4];
+    float t4[4], u4[4], v4[4];
+
+    assert (intersect (a, b, c, px, py, pz, dx, dy, dz, 4, hit4, t4, u4, v4) == 2);
+    assert (hit4[0] && t4[0] == 0.5f && u4[0] == 0.25f && v4[0] == 0.25f);
+    assert (!hit4[1] && !hit4[2]);
+    assert (hit4[3] && t4[3] == 0);
+
+    assert (intersect (a, b, b, px, py, pz, dx, dy, dz, 4, hit4, t4, u4, v4) == 0);
+}
+
+void
+testBatchedClosestPoints()
+{
+    cout << "closest points on many lines" << endl;
+
+    Rand48 rand (3);
+
+    const size_t n = 200;
+
+    std::vector<float> px (n), py (n), pz (n), dx (n), dy (n), dz (n), t1 (n), t2 (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3f p = solidSphereRand<V3f> (rand) * 10.f;
+        V3f d = hollowSphereRand<V3f> (rand);
+
+        px[i] = p.x, py[i] = p.y, pz[i] = p.z;
+        dx[i] = d.x, dy[i] = d.y, dz[i] = d.z;
+    }
+
+    Line3f line (V3f (1, 2, 3), V3f (2, 1, 5));
+
+    //
+    // Include lines parallel to, and coincident with, the line.
+    //
+
+    for (size_t i = 0; i < n; i += 17)
+    {
+        V3f p = line.pos + V3f (0, 0, float (i % 3));
+
+        px[i] = p.x, py[i] = p.y, pz[i] = p.z;
+        dx[i] = line.dir.x, dy[i] = line.dir.y, dz[i] = line.dir.z;
+    }
+
+    closestPoints (line, &px[0], &py[0], &pz[0], &dx[0], &dy[0], &dz[0], n, &t1[0], &t2[0]);
+
+    int expected     = -1;
+    float expectedD2 = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Line3f other;
+        other.pos = V3f (px[i], py[i], pz[i]);
+        other.dir = V3f (dx[i], dy[i], dz[i]);
+
+        V3f point1, point2;
+
+        if (closestPoints (line, other, point1, point2))
+        {
+            assert (point1.equalWithAbsError (line (t1[i]), 1e-3f));
+            assert (point2.equalWithAbsError (other (t2[i]), 1e-3f));
+        }
+        else
+        {
+            point1 = line.pos;
+            point2 = other.closestPointTo (line.pos);
+
+            assert (t1[i] == 0);
+            assert (point2.equalWithAbsError (other (t2[i]), 1e-4f));
+        }
+
+        float d2 = (point1 - point2).length2();
+
+        if (expected < 0 || d2 < expectedD2)
+        {
+            expected   = int (i);
+            expectedD2 = d2;
+        }
+    }
+
+    V3f point1, point2;
+
+    assert (expected % 17 == 0);
+    assert (closestLine (line, &px[0], &py[0], &pz[0], &dx[0], &dy[0], &dz[0], n, point1, point2) ==
+            expected);
+    assert (point1 == line.pos);
+    assert (point2.equalWithAbsError (line.pos, 1e-5f));
+
+    assert (closestLine (line, &px[0], &py[0], &pz[0], &dx[0], &dy[0], &dz[0], 0, point1, point2) ==
+            -1);
+
+    //
+    // Vertices: the first of equally close points is returned, as by
+    // the three-vertex closestVertex().
+    //
+
+    std::vector<float> x (n), y (n), z (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        V3f v = solidSphereRand<V3f> (rand) * 10.f;
+        x[i]  = v.x, y[i] = v.y, z[i] = v.z;
+    }
+
+    expected = 0;
+
+    for (size_t i = 1; i < n; ++i)
+    {
+        V3f v (x[i], y[i], z[i]);
+        V3f e (x[expected], y[expected], z[expected]);
+
+        if ((v - line.closestPointTo (v)).length2() < (e - line.closestPointTo (e)).length2())
+            expected = int (i);
+    }
+
+    assert (closestVertex (&x[0], &y[0], &z[0], n, line) == expected);
+    assert (closestVertex (&x[0], &y[0], &z[0], 0, line) == -1);
+
+    size_t last = n - 1;
+
+    x[last] = x[expected], y[last] = y[expected], z[last] = z[expected];
+
+    assert (closestVertex (&x[0], &y[0], &z[0], n, line) == expected);
+
+    if (size_t (expected) < last)
+    {
+        size_t k = expected + 1;
+        assert (closestVertex (&x[k], &y[k], &z[k], n - k, line) == int (last - k));
+    }
+
+    for (int i = 0; i < 100; ++i)
+    {
+        V3f v[3];
+
+        for (int j = 0; j < 3; ++j)
+            v[j] = solidSphereRand<V3f> (rand);
+
+        float vx[3] = { v[0].x, v[1].x, v[2].x };
+        float vy[3] = { v[0].y, v[1].y, v[2].y };
+        float vz[3] = { v[0].z, v[1].z, v[2].z };
+
+        V3f c = closestVertex (v[0], v[1], v[2], line);
+        assert (c == v[closestVertex (vx, vy, vz, 3, line)]);
+    }
+}
+
 } // namespace
 
 void
@@ -422,6 +776,8 @@ testLineAlgo()
 
     testClosestPoints();
     testIntersect();
+    testPacketIntersect();
+    testBatchedClosestPoints();
 
     cout << "ok\n" << endl;
 }
@@ -0,0 +1,265 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathFrustum.h>
+#include <ImathPlane.h>
+#include <ImathRandom.h>
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <vector>
+#include "testPlane.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+void
+testClassify()
+{
+    Rand48 rand (0);
+
+    const size_t n = 200;
+
+    std::vector<T> x (n), y (n), z (n), distances (n), batched (n);
+    std::vector<uint64_t> above ((n + 63) / 64);
+
+    for (int q = 0; q < 20; ++q)
+    {
+        Plane3<T> plane (Vec3<T> (rand.nextf (-1, 1), rand.nextf (-1, 1), rand.nextf (-1, 1)),
+                         hollowSphereRand<Vec3<T>> (rand));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            Vec3<T> p (rand.nextf (-2, 2), rand.nextf (-2, 2), rand.nextf (-2, 2));
+
+            //
+            // Include points on the plane.
+            //
+
+            if (i % 10 == 0)
+                p = plane.normal * plane.distance;
+
+            x[i] = p.x, y[i] = p.y, z[i] = p.z;
+        }
+
+        //
+        // All the remainders modulo the word size, with and without
+        // full words before them, and the whole array
+        //
+
+        std::vector<size_t> sizes (1, n);
+
+        for (size_t m = 0; m < 130; ++m)
+            sizes.push_back (m);
+
+        for (size_t m : sizes)
+        {
+            above.assign (above.size(), ~uint64_t (0));
+
+            size_t count = plane.classify (&x[0], &y[0], &z[0], m, &distances[0], &above[0]);
+            size_t expectedCount = 0;
+
+            plane.distanceTo (&x[0], &y[0], &z[0], m, &batched[0]);
+
+            for (size_t i = 0; i < m; ++i)
+            {
+                T d = plane.distanceTo (Vec3<T> (x[i], y[i], z[i]));
+
+                assert (equalWithAbsError (distances[i], d, T (1e-5)));
+                assert (distances[i] == batched[i]);
+                assert (bool ((above[i / 64] >> (i % 64)) & 1) == (distances[i] > 0));
+
+                expectedCount += distances[i] > 0;
+            }
+
+            assert (count == expectedCount);
+
+            if (m % 64)
+                assert ((above[m / 64] >> (m % 64)) == 0);
+        }
+    }
+}
+
+template <class T>
+T
+area (const Vec3<T>* polygon, size_t n)
+{
+    Vec3<T> a (0);
+
+    for (size_t i = 0; i < n; ++i)
+        a += polygon[i] % polygon[(i + 1) % n];
+
+    return a.length() / 2;
+}
+
+template <class T>
+void
+testClipPolygon()
+{
+    Vec3<T> result[16], scratch[16];
+
+    //
+    // A square clipped by one, two and no planes
+    //
+
+    Vec3<T> square[4] = { Vec3<T> (0, 0, 1), Vec3<T> (2, 0, 1), Vec3<T> (2, 2, 1), Vec3<T> (0, 2, 1) };
+    Plane3<T> planes[2] = { Plane3<T> (Vec3<T> (1, 0, 0), 1), Plane3<T> (Vec3<T> (0, 1, 0), T (1.5)) };
+
+    assert (clipPolygon (square, 4, planes, 1, result, scratch) == 4);
+    assert (result[0] == Vec3<T> (0, 0, 1));
+    assert (result[1] == Vec3<T> (1, 0, 1));
+    assert (result[2] == Vec3<T> (1, 2, 1));
+    assert (result[3] == Vec3<T> (0, 2, 1));
+
+    assert (clipPolygon (square, 4, planes, 2, result, scratch) == 4);
+    assert (area (result, 4) == T (1.5));
+
+    assert (clipPolygon (square, 4, planes, 0, result, scratch) == 4);
+    assert (std::equal (square, square + 4, result));
+
+    assert (clipPolygon (square, 0, planes, 2, result, scratch) == 0);
+
+    //
+    // Polygons inside and outside a plane, and with vertices and
+    // edges on it, which are kept, but not duplicated.
+    //
+
+    Plane3<T> inside (Vec3<T> (0, 0, 1), 3);
+    Plane3<T> outside (Vec3<T> (0, 0, -1), -2);
+    Plane3<T> edge (Vec3<T> (1, 0, 0), 2);
+
+    assert (clipPolygon (square, 4, &inside, 1, result, scratch) == 4);
+    assert (std::equal (square, square + 4, result));
+    assert (clipPolygon (square, 4, &outside, 1, result, scratch) == 0);
+    assert (clipPolygon (square, 4, &edge, 1, result, scratch) == 4);
+    assert (std::equal (square, square + 4, result));
+
+    Vec3<T> diamond[4] = { Vec3<T> (1, 0, 0), Vec3<T> (2, 1, 0), Vec3<T> (1, 2, 0), Vec3<T> (0, 1, 0) };
+    Plane3<T> corner (Vec3<T> (1, 0, 0), 2);
+    Plane3<T> diagonal (Vec3<T> (1, 0, 0), 1);
+
+    assert (clipPolygon (diamond, 4, &corner, 1, result, scratch) == 4);
+    assert (std::equal (diamond, diamond + 4, result));
+    assert (clipPolygon (diamond, 4, &diagonal, 1, result, scratch) == 3);
+    assert (result[0] == diamond[0] && result[1] == diamond[2] && result[2] == diamond[3]);
+
+    //
+    // Polygons in a plane, clipped by that plane from either side:
+    // rounding makes the signs of the distances of the vertices
+    // alternate, but the vertices are on the plane, and are kept.
+    //
+
+    Rand48 coplanarRand (0);
+
+    for (int q = 0; q < 10000; ++q)
+    {
+        Vec3<T> normal = hollowSphereRand<Vec3<T>> (coplanarRand);
+        Plane3<T> plane (normal, T (coplanarRand.nextf (-10, 10)));
+        Vec3<T> u = (normal % hollowSphereRand<Vec3<T>> (coplanarRand)).normalized();
+        Vec3<T> v = normal % u;
+        Vec3<T> c = normal * plane.distance + u * T (coplanarRand.nextf (-5, 5));
+        T r       = T (coplanarRand.nextf (0.1, 5));
+
+        Vec3<T> coplanar[4] = { c, c + u * r, c + (u + v) * r, c + v * r };
+
+        assert (clipPolygon (coplanar, 4, &plane, 1, result, scratch) == 4);
+        assert (std::equal (coplanar, coplanar + 4, result));
+
+        Plane3<T> flipped = -plane;
+        assert (clipPolygon (coplanar, 4, &flipped, 1, result, scratch) == 4);
+    }
+
+    //
+    // Random convex polygons clipped by a frustum: the result is inside
+    // all of the planes, and keeps the vertices that are.
+    //
+
+    Rand48 rand (1);
+
+    Frustum<T> frustum (T (0.1), T (10), T (-1), T (1), T (0.8), T (-0.6), false);
+    Plane3<T> frustumPlanes[6];
+    frustum.planes (frustumPlanes);
+
+    const size_t n = 10;
+    Vec3<T> polygon[n];
+
+    for (int q = 0; q < 1000; ++q)
+    {
+        Vec3<T> c (rand.nextf (-3, 3), rand.nextf (-3, 3), rand.nextf (-12, 2));
+        Vec3<T> u = hollowSphereRand<Vec3<T>> (rand);
+        Vec3<T> v = (u % hollowSphereRand<Vec3<T>> (rand)).normalized();
+        Vec3<T> w = u % v;
+        T r       = T (rand.nextf (0.1, 5));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T a        = T (2 * M_PI * i / n);
+            polygon[i] = c + (v * std::cos (a) + w * std::sin (a)) * r;
+        }
+
+        size_t m = clipPolygon (polygon, n, frustumPlanes, 6, result, scratch);
+
+        assert (m <= n + 6);
+        assert (m == 0 || m >= 3);
+
+        for (size_t i = 0; i < m; ++i)
+            for (int j = 0; j < 6; ++j)
+                assert (frustumPlanes[j].distanceTo (result[i]) <= T (1e-4));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool in = true;
+
+            for (int j = 0; j < 6; ++j)
+                in = in && frustumPlanes[j].distanceTo (polygon[i]) <= 0;
+
+            if (in)
+                assert (std::find (result, result + m, polygon[i]) != result + m);
+        }
+
+        //
+        // Clipping by the planes one at a time gives the same polygon.
+        //
+
+        Vec3<T> step[16];
+        size_t k = n;
+        std::copy (polygon, polygon + n, step);
+
+        for (int j = 0; j < 6; ++j)
+        {
+            k = clipPolygon (step, k, &frustumPlanes[j], 1, result, scratch);
+            std::copy (result, result + k, step);
+        }
+
+        assert (k == clipPolygon (polygon, n, frustumPlanes, 6, result, scratch));
+        assert (std::equal (step, step + k, result));
+    }
+}
+
+} // namespace
+
+void
+testPlane()
+{
+    cout << "Testing planes" << endl;
+
+    cout << "  batched distances and classification" << endl;
+    testClassify<float>();
+    testClassify<double>();
+
+    cout << "  polygon clipping" << endl;
+    testClipPolygon<float>();
+    testClipPolygon<double>();
+
+    cout << "ok\n" << endl;
+}
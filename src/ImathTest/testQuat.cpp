@@ -14,6 +14,7 @@
 #include <cassert>
 #include <cmath>
 #include <iostream>
+#include <vector>
 #include "testQuat.h"
 
 // Include ImathForward *after* other headers to validate forward declarations
@@ -231,6 +232,71 @@ testQuatConversions ()
     }
 }
 
+template <class T>
+void
+testQuatArrayConversions ()
+{
+    //
+    // Rotation matrices exercising every case of extractQuat():
+    // a positive trace, and each of the diagonal elements largest,
+    // plus ties and a degenerate matrix.
+    //
+
+    std::vector<Matrix44<T>> m;
+
+    m.push_back (Matrix44<T>());
+    m.push_back (Matrix44<T> (T (0)));
+    m.push_back (Matrix44<T>().rotate (Vec3<T> (M_PI, 0, 0)));
+    m.push_back (Matrix44<T>().rotate (Vec3<T> (0, M_PI, 0)));
+    m.push_back (Matrix44<T>().rotate (Vec3<T> (0, 0, M_PI)));
+    m.push_back (Matrix44<T> (-1, 0, 0, 0, 0, -1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1));
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        Vec3<T> axis (std::sin (i * T (0.37)), std::cos (i * T (1.13)), std::sin (i * T (2.71)));
+        T angle = T (M_PI) * (i % 100) / T (50) - T (M_PI);
+
+        Quat<T> q;
+        q.setAxisAngle (axis, angle);
+        m.push_back (q.toMatrix44());
+    }
+
+    size_t n = m.size();
+    std::vector<T> r (n), x (n), y (n), z (n);
+    std::vector<Quat<T>> q (n);
+
+    extractQuat (&m[0], n, &r[0], &x[0], &y[0], &z[0]);
+    extractQuat (&m[0], n, &q[0]);
+
+    T e = 4 * std::numeric_limits<T>::epsilon();
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        Quat<T> expected = extractQuat (m[i]);
+
+        assert (equalWithAbsError (r[i], expected.r, e));
+        assert (equalWithAbsError (x[i], expected.v.x, e));
+        assert (equalWithAbsError (y[i], expected.v.y, e));
+        assert (equalWithAbsError (z[i], expected.v.z, e));
+        assert (q[i] == Quat<T> (r[i], x[i], y[i], z[i]));
+    }
+
+    std::vector<Matrix44<T>> result (n), resultAoS (n);
+
+    quatToMatrix44 (&r[0], &x[0], &y[0], &z[0], n, &result[0]);
+    quatToMatrix44 (&q[0], n, &resultAoS[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (result[i].equalWithAbsError (q[i].toMatrix44(), e));
+        assert (resultAoS[i] == q[i].toMatrix44());
+
+        // m[1] is the degenerate matrix, which doesn't round trip
+        if (i != 1)
+            assert (result[i].equalWithAbsError (m[i], 100 * e));
+    }
+}
+
 } // namespace
 
 
@@ -242,6 +308,8 @@ testQuat ()
     testQuatT<float>();
     testQuatT<double>();
     testQuatConversions();
+    testQuatArrayConversions<float>();
+    testQuatArrayConversions<double>();
 
     cout << "ok\n" << endl;
 }
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <iostream>
 #include <math.h>
+#include <vector>
 #include "testQuatSlerp.h"
 
 using namespace std;
@@ -153,6 +154,77 @@ randomRotations()
     }
 }
 
+float
+rotationError (const Quatf& q1, const Quatf& q2)
+{
+    //
+    // The angle of the rotation that takes q1 to q2.
+    //
+
+    return 2 * angle4D (q1, (q1 ^ q2) < 0 ? -q2 : q2);
+}
+
+void
+approximateAndArrayRotations()
+{
+    cout << "  approximate and array interpolation" << endl;
+
+    Rand48 rand (17);
+
+    const size_t n = 10000;
+    std::vector<Quatf> q1 (n), q2 (n), result (n);
+    std::vector<float> t (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        q1[i].setAxisAngle (hollowSphereRand<V3f> (rand), rand.nextf (-M_PI, M_PI));
+        q2[i].setAxisAngle (hollowSphereRand<V3f> (rand), rand.nextf (-M_PI, M_PI));
+        t[i] = rand.nextf (0, 1);
+    }
+
+    float e = 10 * std::numeric_limits<float>::epsilon();
+
+    slerp (&q1[0], &q2[0], &t[0], n, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        compareQuats (result[i], slerp (q1[i], q2[i], t[i]), e);
+
+    slerpShortestArc (&q1[0], &q2[0], &t[0], n, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        compareQuats (result[i], slerpShortestArc (q1[i], q2[i], t[i]), e);
+
+    nlerp (&q1[0], &q2[0], &t[0], n, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        compareQuats (result[i], nlerp (q1[i], q2[i], t[i]), e);
+        assert (rotationError (result[i], slerpShortestArc (q1[i], q2[i], t[i])) < 0.15f);
+    }
+
+    slerpFast (&q1[0], &q2[0], &t[0], n, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        compareQuats (result[i], slerpFast (q1[i], q2[i], t[i]), e);
+        assert (rotationError (result[i], slerpShortestArc (q1[i], q2[i], t[i])) < 8e-4f);
+    }
+
+    //
+    // The approximations are exact at the end points and the midpoint.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (float u : { 0.0f, 0.5f, 1.0f })
+        {
+            Quatf q = slerpShortestArc (q1[i], q2[i], u);
+            assert (rotationError (nlerp (q1[i], q2[i], u), q) < 1e-5f);
+            assert (rotationError (slerpFast (q1[i], q2[i], u), q) < 1e-5f);
+        }
+    }
+}
+
 } // namespace
 
 void
@@ -162,6 +234,7 @@ testQuatSlerp()
 
     specificRotations();
     randomRotations();
+    approximateAndArrayRotations();
 
     cout << "ok\n" << endl;
 }
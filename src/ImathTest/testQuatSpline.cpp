@@ -0,0 +1,170 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathQuatSpline.h>
+#include <ImathRandom.h>
+#include <assert.h>
+#include <iostream>
+#include <math.h>
+#include <vector>
+#include "testQuatSpline.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+void
+compareQuats (const Quatd& q1, const Quatd& q2, double e)
+{
+    assert (equalWithAbsError (q1.v.x, q2.v.x, e));
+    assert (equalWithAbsError (q1.v.y, q2.v.y, e));
+    assert (equalWithAbsError (q1.v.z, q2.v.z, e));
+    assert (equalWithAbsError (q1.r, q2.r, e));
+}
+
+void
+testEmptyAndSingle()
+{
+    cout << "  empty and single-key curves" << endl;
+
+    QuatSplined empty;
+
+    assert (empty.numKeys() == 0);
+    assert (empty.evaluate (0.5) == Quatd());
+
+    Quatd q;
+    q.setAxisAngle (V3d (0, 1, 0), 0.5);
+
+    QuatSplined single (&q, 1);
+
+    assert (single.numKeys() == 1);
+    assert (single.evaluate (-1.0) == q);
+    assert (single.evaluate (3.0) == q);
+
+    double times[] = { 0, 1, 2 };
+    Quatd result[3];
+
+    single.evaluate (times, 3, result);
+
+    for (int i = 0; i < 3; ++i)
+        assert (result[i] == q);
+}
+
+void
+testAgainstSpline()
+{
+    cout << "  comparison with spline()" << endl;
+
+    Rand48 rand (19);
+
+    const size_t n = 12;
+    std::vector<Quatd> keys (n);
+
+    for (size_t i = 0; i < n; ++i)
+        keys[i].setAxisAngle (hollowSphereRand<V3d> (rand), rand.nextf (-M_PI / 2, M_PI / 2));
+
+    QuatSplined curve (&keys[0], n);
+
+    assert (curve.numKeys() == n);
+    assert (curve.startTime() == 0);
+    assert (curve.endTime() == n - 1);
+
+    double e = 1e-12;
+
+    for (size_t i = 0; i + 1 < n; ++i)
+    {
+        const Quatd& q0 = keys[i > 0 ? i - 1 : 0];
+        const Quatd& q1 = keys[i];
+        const Quatd& q2 = keys[i + 1];
+        const Quatd& q3 = keys[i + 2 < n ? i + 2 : n - 1];
+
+        for (int j = 0; j <= 10; ++j)
+        {
+            double t = j / 10.0;
+            compareQuats (curve.evaluate (i + t), spline (q0, q1, q2, q3, t), e);
+        }
+    }
+
+    //
+    // The curve passes through the keys and is clamped outside them.
+    //
+
+    for (size_t i = 0; i < n; ++i)
+        compareQuats (curve.evaluate (double (i)), keys[i], e);
+
+    compareQuats (curve.evaluate (-2.0), keys[0], e);
+    compareQuats (curve.evaluate (n + 2.0), keys[n - 1], e);
+}
+
+void
+testBatch()
+{
+    cout << "  batch evaluation" << endl;
+
+    Rand48 rand (23);
+
+    const size_t n = 8;
+    std::vector<Quatd> keys (n);
+    std::vector<double> keyTimes (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        keys[i].setAxisAngle (hollowSphereRand<V3d> (rand), rand.nextf (-M_PI / 2, M_PI / 2));
+        keyTimes[i] = (i ? keyTimes[i - 1] : 0.0) + rand.nextf (0.1, 2.0);
+    }
+
+    QuatSplined curve (&keys[0], &keyTimes[0], n);
+
+    assert (curve.startTime() == keyTimes[0]);
+    assert (curve.endTime() == keyTimes[n - 1]);
+
+    //
+    // Sorted sample times, then the same samples shuffled.
+    //
+
+    const size_t m = 1000;
+    std::vector<double> times (m);
+    std::vector<Quatd> result (m);
+
+    for (size_t i = 0; i < m; ++i)
+        times[i] = curve.startTime() - 1 +
+                   (curve.endTime() - curve.startTime() + 2) * i / (m - 1);
+
+    curve.evaluate (&times[0], m, &result[0]);
+
+    for (size_t i = 0; i < m; ++i)
+        assert (result[i] == curve.evaluate (times[i]));
+
+    for (size_t i = m - 1; i > 0; --i)
+        std::swap (times[i], times[rand.nexti() % (i + 1)]);
+
+    curve.evaluate (&times[0], m, &result[0]);
+
+    for (size_t i = 0; i < m; ++i)
+        assert (result[i] == curve.evaluate (times[i]));
+
+    for (size_t i = 0; i < n; ++i)
+        compareQuats (curve.evaluate (keyTimes[i]), keys[i], 1e-12);
+}
+
+} // namespace
+
+void
+testQuatSpline()
+{
+    cout << "Testing quaternion spline curves" << endl;
+
+    testEmptyAndSingle();
+    testAgainstSpline();
+    testBatch();
+
+    cout << "ok\n" << endl;
+}
@@ -8,11 +8,13 @@
 #endif
 
 #include <ImathFun.h>
+#include <ImathRandom.h>
 #include <ImathRoots.h>
 #include <algorithm>
 #include <assert.h>
 #include <iomanip>
 #include <iostream>
+#include <vector>
 #include "testRoots.h"
 
 using namespace std;
@@ -176,6 +178,436 @@ solve (double a,
     cout << endl;
 }
 
+namespace
+{
+
+//
+// Sort the n roots x[0] to x[n-1], where n is at most 4.
+//
+
+template <class T>
+void
+sortRoots (T* x, int n)
+{
+    for (int i = 1; i < n; ++i)
+        for (int j = i; j > 0 && x[j] < x[j - 1]; --j)
+            std::swap (x[j], x[j - 1]);
+}
+
+} // namespace
+
+template <class T>
+void
+solveBatched (const std::vector<T>& a,
+              const std::vector<T>& b,
+              const std::vector<T>& c,
+              const std::vector<T>& d,
+              T e) // maximum expected error, relative to the largest solution
+{
+    //
+    // The batched solvers agree with the scalar ones on the number of
+    // solutions, and on the solutions themselves: exactly for
+    // quadratic equations, which are solved the same way, and within
+    // e for cubic equations, which are solved with real arithmetic.
+    //
+
+    size_t n = a.size();
+
+    std::vector<T> x0 (n), x1 (n), x2 (n);
+    std::vector<int> numRoots (n);
+
+    IMATH_INTERNAL_NAMESPACE::solveQuadratic (&a[0], &b[0], &c[0], n, &x0[0], &x1[0], &numRoots[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T x[2];
+        int nx = IMATH_INTERNAL_NAMESPACE::solveQuadratic (a[i], b[i], c[i], x);
+
+        assert (numRoots[i] == nx);
+        assert (nx < 1 || x0[i] == x[0]);
+        assert (nx < 2 || x1[i] == x[1]);
+    }
+
+    IMATH_INTERNAL_NAMESPACE::solveCubic (
+        &a[0], &b[0], &c[0], &d[0], n, &x0[0], &x1[0], &x2[0], &numRoots[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T x[3];
+        int nx = IMATH_INTERNAL_NAMESPACE::solveCubic (a[i], b[i], c[i], d[i], x);
+
+        assert (numRoots[i] == nx);
+
+        T y[3] = { x0[i], x1[i], x2[i] };
+        sortRoots (x, nx);
+        sortRoots (y, nx);
+
+        T scale = 1;
+
+        for (int j = 0; j < nx; ++j)
+            scale = std::max (scale, std::abs (x[j]));
+
+        for (int j = 0; j < nx; ++j)
+            assert (std::abs (y[j] - x[j]) <= e * scale);
+    }
+}
+
+template <class T>
+void
+testBatched (T e)
+{
+    IMATH_INTERNAL_NAMESPACE::Rand48 rand (0);
+
+    std::vector<T> a, b, c, d;
+
+    //
+    // The special cases above, including a == 0 and all coefficients
+    // zero
+    //
+
+    const T cases[][4] = {
+        { 1, 6, 11, 6 },    { 2, 2, -20, 16 },   { 3, -3, 1, -1 },  { 2, 0, -24, -32 },
+        { 1, 0, 0, 0 },     { 8, -24, 24, -8 },  { 1, 0, -3, 3 },   { 0, 2, -10, 12 },
+        { 0, 3, -12, 12 },  { 0, 1, 0, 1 },      { 0, 0, 5, 15 },   { 0, 0, 0, 1 },
+        { 0, 0, 0, 0 },     { 1, 3, 2, 0 },      { 2, -4, 2, 0 },   { 3, -6, 30, 0 }
+    };
+
+    for (size_t i = 0; i < sizeof (cases) / sizeof (cases[0]); ++i)
+    {
+        a.push_back (cases[i][0]);
+        b.push_back (cases[i][1]);
+        c.push_back (cases[i][2]);
+        d.push_back (cases[i][3]);
+    }
+
+    //
+    // Products of linear factors with small integer roots, which have
+    // double and triple roots, and random coefficients, some of them
+    // zero. The number of equations is not a multiple of 64.
+    //
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        T k  = T (rand.nexti() % 4 + 1);
+        T r0 = T (int (rand.nexti() % 5) - 2);
+        T r1 = T (int (rand.nexti() % 5) - 2);
+        T r2 = T (int (rand.nexti() % 5) - 2);
+
+        a.push_back (k);
+        b.push_back (-k * (r0 + r1 + r2));
+        c.push_back (k * (r0 * r1 + r1 * r2 + r0 * r2));
+        d.push_back (-k * r0 * r1 * r2);
+
+        T coeffs[4];
+
+        for (int j = 0; j < 4; ++j)
+            coeffs[j] = rand.nexti() % 8 ? T (rand.nextf (-10, 10)) : T (0);
+
+        a.push_back (coeffs[0]);
+        b.push_back (coeffs[1]);
+        c.push_back (coeffs[2]);
+        d.push_back (coeffs[3]);
+    }
+
+    a.push_back (1);
+    b.push_back (2);
+    c.push_back (3);
+    d.push_back (4);
+
+    solveBatched (a, b, c, d, e);
+
+    //
+    // Empty batches don't touch the results.
+    //
+
+    int numRoots = 7;
+    IMATH_INTERNAL_NAMESPACE::solveQuadratic<T> (
+        nullptr, nullptr, nullptr, 0, nullptr, nullptr, &numRoots);
+    IMATH_INTERNAL_NAMESPACE::solveCubic<T> (
+        nullptr, nullptr, nullptr, nullptr, 0, nullptr, nullptr, nullptr, &numRoots);
+    assert (numRoots == 7);
+}
+
+namespace
+{
+
+//
+// Multiply the polynomial p, with coefficients from the highest
+// degree down, by a * x*x + b * x + c, or by b * x + c if a is zero.
+//
+
+std::vector<double>
+times (const std::vector<double>& p, double a, double b, double c)
+{
+    std::vector<double> q (p.size() + 2, 0.0);
+
+    for (size_t i = 0; i < p.size(); ++i)
+    {
+        q[i] += a * p[i];
+        q[i + 1] += b * p[i];
+        q[i + 2] += c * p[i];
+    }
+
+    if (a == 0)
+        q.erase (q.begin());
+
+    return q;
+}
+
+} // namespace
+
+template <class T>
+void
+checkQuartic (const std::vector<double>& p, // coefficients
+              const std::vector<double>& r, // distinct expected solutions
+              int nx,                       // number of expected solutions, or
+                                            // -2 for any, with multiple solutions
+              T e,                          // maximum expected error, relative to
+                                            // the largest solution
+              bool conditioned = false)     // or to the condition number of
+                                            // each solution
+{
+    T x[4];
+    int n =
+        IMATH_INTERNAL_NAMESPACE::solveQuartic (T (p[0]), T (p[1]), T (p[2]), T (p[3]), T (p[4]), x);
+
+    assert (nx == -2 ? n >= int (r.size()) && n <= 4 : n == nx);
+
+    double scale = 1;
+
+    for (size_t j = 0; j < r.size(); ++j)
+        scale = std::max (scale, std::abs (r[j]));
+
+    //
+    // The condition number of a simple solution is the sum of the
+    // magnitudes of the terms of the polynomial, over the magnitude
+    // of its derivative.
+    //
+
+    std::vector<double> tolerance (r.size(), e * scale);
+
+    for (size_t j = 0; j < r.size() && conditioned; ++j)
+    {
+        double terms = 0, derivative = 0;
+
+        for (int k = 0; k < 5; ++k)
+        {
+            terms += std::abs (p[k] * std::pow (r[j], 4 - k));
+            derivative += k < 4 ? (4 - k) * p[k] * std::pow (r[j], 3 - k) : 0;
+        }
+
+        tolerance[j] = e * terms / std::abs (derivative);
+    }
+
+    //
+    // Every solution found is close to an expected one, and the other
+    // way around.
+    //
+
+    for (int i = 0; i < n; ++i)
+    {
+        bool found = false;
+
+        for (size_t j = 0; j < r.size(); ++j)
+            found = found || std::abs (x[i] - r[j]) <= tolerance[j];
+
+        assert (found);
+    }
+
+    for (size_t j = 0; j < r.size(); ++j)
+    {
+        bool found = false;
+
+        for (int i = 0; i < n; ++i)
+            found = found || std::abs (x[i] - r[j]) <= tolerance[j];
+
+        assert (found);
+    }
+}
+
+template <class T>
+void
+testQuartic (T e, T eMultiple, T eConditioned)
+{
+    IMATH_INTERNAL_NAMESPACE::Rand48 rand (0);
+
+    const std::vector<double> one (1, 1.0);
+    const std::vector<double> none;
+
+    //
+    // Lower degrees
+    //
+
+    checkQuartic<T> ({ 0, 1, 6, 11, 6 }, { -1, -2, -3 }, 3, e);
+    checkQuartic<T> ({ 0, 0, 1, -1, -20 }, { 5, -4 }, 2, e);
+    checkQuartic<T> ({ 0, 0, 0, 5, 15 }, { -3 }, 1, e);
+    checkQuartic<T> ({ 0, 0, 0, 0, 1 }, none, 0, e);
+    checkQuartic<T> ({ 0, 0, 0, 0, 0 }, none, -1, e);
+
+    //
+    // Distinct solutions, a biquadratic equation, a quartic whose
+    // depressed form has q == 0 but is not biquadratic, solutions of
+    // very different magnitudes, and no solutions
+    //
+
+    checkQuartic<T> (times (times (one, 1, -3, 2), 1, 1, -12), { 1, 2, 3, -4 }, 4, e);
+    checkQuartic<T> ({ 1, 0, -5, 0, 4 }, { -2, -1, 1, 2 }, 4, e);
+    checkQuartic<T> ({ 2, 0, -10, 0, 8 }, { -2, -1, 1, 2 }, 4, e);
+    checkQuartic<T> ({ 1, -4, 1, 6, 0 }, { -1, 0, 2, 3 }, 4, e);
+    checkQuartic<T> (times (times (one, 1, -10.001, 0.01), 1, -1100, 100000),
+                     { 0.001, 10, 100, 1000 },
+                     4,
+                     e);
+    checkQuartic<T> (times (times (one, 1, 1, 1), 1, 0, 4), none, 0, e);
+    checkQuartic<T> (times (times (one, 1, 0, 1), 1, -3, 2), { 1, 2 }, 2, e);
+
+    //
+    // Multiple solutions
+    //
+
+    checkQuartic<T> ({ 1, -4, 6, -4, 1 }, { 1 }, -2, eMultiple);
+    checkQuartic<T> ({ 1, 0, 0, 0, 0 }, { 0 }, -2, eMultiple);
+    checkQuartic<T> (times (times (one, 1, -2, 1), 1, 4, 4), { 1, -2 }, -2, eMultiple);
+    checkQuartic<T> (times (times (one, 1, -2, 1), 1, 1, -6), { 1, 2, -3 }, -2, eMultiple);
+    checkQuartic<T> (
+        times (times (times (one, 1, -2, 1), 0, 1, -1), 0, 1, 1), { 1, -1 }, -2, eMultiple);
+    checkQuartic<T> (times (times (one, 1, 0, 1), 1, 0, 1), none, 0, e);
+
+    //
+    // Scaled coefficients don't change the solutions.
+    //
+
+    checkQuartic<T> ({ 1e-10, 0, -5e-10, 0, 4e-10 }, { -2, -1, 1, 2 }, 4, e);
+    checkQuartic<T> ({ 1e10, 0, -5e10, 0, 4e10 }, { -2, -1, 1, 2 }, 4, e);
+
+    //
+    // A ray along the x axis, from (-5, 0, 0), through a torus around
+    // the z axis, with radii 2 and 0.5: the distances t solve
+    //
+    //   (|o + t d|^2 + R^2 - r^2)^2 - 4 R^2 ((ox + t dx)^2 + (oy + t dy)^2) == 0
+    //
+
+    {
+        double R = 2, r = 0.5, ox = -5;
+        double k = ox * ox + R * R - r * r;
+
+        checkQuartic<T> ({ 1, 4 * ox, 4 * ox * ox + 2 * k - 4 * R * R, 4 * ox * k - 8 * R * R * ox,
+                           k * k - 4 * R * R * ox * ox },
+                         { 2.5, 3.5, 6.5, 7.5 },
+                         4,
+                         e);
+    }
+
+    //
+    // Random solutions, well separated, and with a pair of complex
+    // solutions
+    //
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        double r[4];
+
+        for (int j = 0; j < 4; ++j)
+            r[j] = rand.nextf (-10, 10);
+
+        std::sort (r, r + 4);
+
+        double k = rand.nextf (0.1, 10) * (i % 2 ? 1 : -1);
+
+        if (r[1] - r[0] > 0.5 && r[2] - r[1] > 0.5 && r[3] - r[2] > 0.5)
+        {
+            std::vector<double> p = times ({ k }, 1, -r[0] - r[1], r[0] * r[1]);
+
+            checkQuartic<T> (times (p, 1, -r[2] - r[3], r[2] * r[3]),
+                             { r[0], r[1], r[2], r[3] },
+                             4,
+                             eConditioned,
+                             true);
+        }
+
+        if (r[1] - r[0] > 0.5)
+        {
+            double s = r[2], t = s * s / 4 + 1 + std::abs (r[3]);
+
+            checkQuartic<T> (times (times ({ k }, 1, -r[0] - r[1], r[0] * r[1]), 1, s, t),
+                             { r[0], r[1] },
+                             2,
+                             eConditioned,
+                             true);
+        }
+    }
+}
+
+template <class T>
+void
+solveQuarticBatched (T e) // maximum expected error, relative to the largest solution
+{
+    //
+    // The batched solver agrees with the scalar one on the number of
+    // solutions and on the solutions, for random equations, random
+    // equations with some zero coefficients, and equations with
+    // distinct integer solutions. Near multiple solutions, the number
+    // of solutions found depends on rounding errors.
+    //
+
+    IMATH_INTERNAL_NAMESPACE::Rand48 rand (1);
+
+    std::vector<T> a, b, c, d, f;
+
+    for (int i = 0; i < 3001; ++i)
+    {
+        T coeffs[5];
+
+        for (int j = 0; j < 5; ++j)
+            coeffs[j] = i % 3 || rand.nexti() % 4 ? T (rand.nextf (-10, 10)) : T (0);
+
+        if (i % 3 == 2)
+        {
+            double r0 = i % 5, r1 = -1 - i % 3, r2 = 5 + i % 4, r3 = -6 - i % 2;
+
+            std::vector<double> p = times (std::vector<double> (1, 1.0), 1, -r0 - r1, r0 * r1);
+            p                     = times (p, 1, -r2 - r3, r2 * r3);
+
+            for (int j = 0; j < 5; ++j)
+                coeffs[j] = T (p[j]);
+        }
+
+        a.push_back (coeffs[0]);
+        b.push_back (coeffs[1]);
+        c.push_back (coeffs[2]);
+        d.push_back (coeffs[3]);
+        f.push_back (coeffs[4]);
+    }
+
+    size_t n = a.size();
+
+    std::vector<T> x0 (n), x1 (n), x2 (n), x3 (n);
+    std::vector<int> numRoots (n);
+
+    IMATH_INTERNAL_NAMESPACE::solveQuartic (
+        &a[0], &b[0], &c[0], &d[0], &f[0], n, &x0[0], &x1[0], &x2[0], &x3[0], &numRoots[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        T x[4];
+        int nx = IMATH_INTERNAL_NAMESPACE::solveQuartic (a[i], b[i], c[i], d[i], f[i], x);
+
+        assert (numRoots[i] == nx);
+
+        T y[4] = { x0[i], x1[i], x2[i], x3[i] };
+        sortRoots (x, nx);
+        sortRoots (y, nx);
+
+        T scale = 1;
+
+        for (int j = 0; j < nx; ++j)
+            scale = std::max (scale, std::abs (x[j]));
+
+        for (int j = 0; j < nx; ++j)
+            assert (std::abs (y[j] - x[j]) <= e * scale);
+    }
+}
+
 void
 testRoots()
 {
@@ -196,6 +628,7 @@ testRoots()
     solve (2, 0, -24, -32, 2, 4, -2, 0); // real solutions: 4, -2
     solve (1, 0, 0, 0, 1, 0, 0, 0);      // real solutions: 0
     solve (8, -24, 24, -8, 1, 1, 0, 0);  // real solutions: 1
+    solve (1, 0, -3, 3, 1, -2.1038034027355366, 0, 0); // real solutions: -2.10380...
     solve (0, 2, -10, 12, 2, 2, 3, 0);   // real solutions: 2, 3
     solve (0, 1, -1, -20, 2, 5, -4, 0);  // real solutions: 5, -4
     solve (0, 3, -12, 12, 1, 2, 0, 0);   // real solutions: 2
@@ -226,5 +659,18 @@ testRoots()
     solve (0, 0, 0, -1, 0, 0);  // real solutions: [-inf, inf]
     solve (0, 0, 1, 0, 0, 0);   // real solutions: none
     solve (3, -6, 30, 0, 0, 0); // real solutions: none
+
+    cout << endl << "batched solveQuadratic and solveCubic" << endl;
+    testBatched<float> (1e-3f);
+    testBatched<double> (1e-7);
+
+    cout << endl << "solveQuartic" << endl;
+    testQuartic<float> (1e-4f, 1e-2f, 1e-5f);
+    testQuartic<double> (1e-10, 1e-5, 1e-13);
+
+    cout << endl << "batched solveQuartic" << endl;
+    solveQuarticBatched<float> (1e-3f);
+    solveQuarticBatched<double> (1e-7);
+
     cout << "ok\n" << endl;
 }
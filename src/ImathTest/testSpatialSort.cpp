@@ -0,0 +1,289 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathRandom.h>
+#include <ImathSpatialSort.h>
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <vector>
+#include "testSpatialSort.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+uint64_t
+interleave (const uint32_t* c, int dims, int bits)
+{
+    uint64_t code = 0;
+
+    for (int b = 0; b < bits; ++b)
+        for (int i = 0; i < dims; ++i)
+            code |= uint64_t ((c[i] >> b) & 1) << (b * dims + i);
+
+    return code;
+}
+
+uint32_t
+distance (uint32_t a, uint32_t b)
+{
+    return a > b ? a - b : b - a;
+}
+
+void
+testMorton()
+{
+    cout << "  Morton codes" << endl;
+
+    Rand48 rand (0);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint32_t c[3] = { uint32_t (rand.nexti()), uint32_t (rand.nexti()), uint32_t (rand.nexti()) };
+        uint32_t x, y, z;
+
+        //
+        // Only the low 16 (2D) or 21 (3D) bits of the coordinates
+        // are encoded.
+        //
+
+        uint32_t code2 = mortonEncode (c[0], c[1]);
+        assert (code2 == interleave (c, 2, 16));
+
+        mortonDecode (code2, x, y);
+        assert (x == (c[0] & 0xffff) && y == (c[1] & 0xffff));
+
+        uint64_t code3 = mortonEncode (c[0], c[1], c[2]);
+        assert (code3 == interleave (c, 3, 21));
+
+        mortonDecode (code3, x, y, z);
+        assert (x == (c[0] & 0x1fffff) && y == (c[1] & 0x1fffff) && z == (c[2] & 0x1fffff));
+    }
+
+    assert (mortonEncode (1, 0, 0) == 1);
+    assert (mortonEncode (0, 1, 0) == 2);
+    assert (mortonEncode (0, 0, 1) == 4);
+    assert (mortonEncode (0x1fffff, 0x1fffff, 0x1fffff) == 0x7fffffffffffffffull);
+    assert (mortonEncode (0xffff, 0xffff) == 0xffffffffu);
+}
+
+void
+testHilbert()
+{
+    cout << "  Hilbert codes" << endl;
+
+    Rand48 rand (1);
+
+    //
+    // Consecutive codes are neighbors in the grid, and the codes
+    // round-trip through the coordinates.
+    //
+
+    uint32_t x, y, z, u, v, w;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint32_t code2 = i < 5000 ? uint32_t (i) : uint32_t (rand.nexti());
+
+        if (code2 == 0xffffffffu)
+            --code2;
+
+        hilbertDecode (code2, x, y);
+        hilbertDecode (code2 + 1, u, v);
+
+        assert (hilbertEncode (x, y) == code2);
+        assert (distance (x, u) + distance (y, v) == 1);
+
+        uint64_t code3 = i < 5000 ? uint64_t (i) : ((uint64_t (rand.nexti()) << 32) | rand.nexti()) >> 2;
+
+        hilbertDecode (code3, x, y, z);
+        hilbertDecode (code3 + 1, u, v, w);
+
+        assert (hilbertEncode (x, y, z) == code3);
+        assert (distance (x, u) + distance (y, v) + distance (z, w) == 1);
+    }
+
+    //
+    // The curve starts at the origin, and covers the grid.
+    //
+
+    assert (hilbertEncode (0, 0) == 0);
+    assert (hilbertEncode (0, 0, 0) == 0);
+
+    std::vector<bool> seen (256 * 256, false);
+
+    for (uint32_t code = 0; code < 256 * 256; ++code)
+    {
+        hilbertDecode (code, x, y);
+        assert (x < 256 && y < 256 && !seen[y * 256 + x]);
+        seen[y * 256 + x] = true;
+    }
+}
+
+template <class T>
+void
+testCodes()
+{
+    Rand48 rand (2);
+
+    const size_t n = 1000;
+
+    Box<Vec3<T>> bounds (Vec3<T> (-1, -2, -3), Vec3<T> (4, 5, 6));
+    Box<Vec2<T>> bounds2 (Vec2<T> (-1, -2), Vec2<T> (4, 5));
+
+    std::vector<Vec3<T>> points (n);
+    std::vector<Vec2<T>> points2 (n);
+    std::vector<Box<Vec3<T>>> boxes (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        points[i]  = Vec3<T> (rand.nextf (-2, 5), rand.nextf (-3, 6), rand.nextf (-4, 7));
+        points2[i] = Vec2<T> (points[i].x, points[i].y);
+        boxes[i]   = Box<Vec3<T>> (points[i]);
+    }
+
+    std::vector<uint64_t> codes (n), codesOfBoxes (n);
+    std::vector<uint32_t> codes2 (n);
+
+    mortonCodes (&points[0], n, bounds, &codes[0]);
+    mortonCodes (&boxes[0], n, bounds, &codesOfBoxes[0]);
+    mortonCodes (&points2[0], n, bounds2, &codes2[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (codes[i] == mortonCode (points[i], bounds));
+        assert (codes2[i] == mortonCode (points2[i], bounds2));
+
+        //
+        // The cells are clamped to the box.
+        //
+
+        uint32_t x, y, z;
+        mortonDecode (codes[i], x, y, z);
+
+        Vec3<T> p = points[i];
+        Vec3<T> s = bounds.size();
+
+        assert (p.x < bounds.min.x ? x == 0 : p.x >= bounds.max.x ? x == 0x1fffff : true);
+        assert (p.z < bounds.min.z ? z == 0 : p.z >= bounds.max.z ? z == 0x1fffff : true);
+
+        if (bounds.intersects (p))
+        {
+            assert (std::abs (T (x) / (1 << 21) * s.x + bounds.min.x - p.x) <= s.x / (1 << 20));
+            assert (std::abs (T (y) / (1 << 21) * s.y + bounds.min.y - p.y) <= s.y / (1 << 20));
+        }
+    }
+
+    assert (codes == codesOfBoxes);
+
+    hilbertCodes (&points[0], n, bounds, &codes[0]);
+    hilbertCodes (&boxes[0], n, bounds, &codesOfBoxes[0]);
+    hilbertCodes (&points2[0], n, bounds2, &codes2[0]);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (codes[i] == hilbertCode (points[i], bounds));
+        assert (codes2[i] == hilbertCode (points2[i], bounds2));
+    }
+
+    assert (codes == codesOfBoxes);
+
+    //
+    // Flat and empty boxes map their flat axes to cell 0.
+    //
+
+    Box<Vec3<T>> flat (Vec3<T> (0, 0, 1), Vec3<T> (1, 1, 1));
+    uint32_t x, y, z;
+
+    mortonDecode (mortonCode (Vec3<T> (T (0.5), T (0.5), 7), flat), x, y, z);
+    assert (x == 1 << 20 && y == 1 << 20 && z == 0);
+
+    assert (mortonCode (Vec3<T> (1, 2, 3), Box<Vec3<T>>()) == 0);
+}
+
+template <class K>
+void
+testRadixSort (Rand48& rand, size_t n, K mask)
+{
+    std::vector<K> keys (n);
+    std::vector<int> values (n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        keys[i]   = K (((uint64_t (rand.nexti()) << 32) | rand.nexti()) & mask);
+        values[i] = int (i);
+    }
+
+    //
+    // The expected order is that of a stable sort.
+    //
+
+    std::vector<std::pair<K, int>> expected (n);
+
+    for (size_t i = 0; i < n; ++i)
+        expected[i] = std::make_pair (keys[i], int (i));
+
+    std::stable_sort (expected.begin(), expected.end(), [] (const std::pair<K, int>& a, const std::pair<K, int>& b) {
+        return a.first < b.first;
+    });
+
+    std::vector<K> keysOnly = keys;
+
+    radixSort (n ? &keys[0] : nullptr, n ? &values[0] : nullptr, n);
+    radixSort (n ? &keysOnly[0] : nullptr, nullptr, n);
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        assert (keys[i] == expected[i].first);
+        assert (values[i] == expected[i].second);
+        assert (keysOnly[i] == expected[i].first);
+    }
+}
+
+void
+testRadixSort()
+{
+    cout << "  radix sort" << endl;
+
+    Rand48 rand (3);
+
+    for (size_t n = 0; n < 5; ++n)
+        testRadixSort<uint64_t> (rand, n, ~uint64_t (0));
+
+    testRadixSort<uint64_t> (rand, 10000, ~uint64_t (0));
+    testRadixSort<uint64_t> (rand, 10000, 0x7fffffffffffffffull);
+    testRadixSort<uint64_t> (rand, 10000, 0xff00ff);
+    testRadixSort<uint64_t> (rand, 10000, 0x3);
+    testRadixSort<uint64_t> (rand, 1000, 0);
+    testRadixSort<uint32_t> (rand, 10000, 0xffffffffu);
+    testRadixSort<uint32_t> (rand, 10000, 0xffffu);
+    testRadixSort<uint8_t> (rand, 1000, 0xff);
+}
+
+} // namespace
+
+void
+testSpatialSort()
+{
+    cout << "Testing spatial sorting" << endl;
+
+    testMorton();
+    testHilbert();
+
+    cout << "  codes of points and boxes" << endl;
+    testCodes<float>();
+    testCodes<double>();
+
+    testRadixSort();
+
+    cout << "ok\n" << endl;
+}
@@ -0,0 +1,234 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathRandom.h>
+#include <ImathSphere.h>
+#include <algorithm>
+#include <assert.h>
+#include <iostream>
+#include <vector>
+#include "testSphere.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+bool
+encloses (const Sphere3<T>& s, const Vec3<T>* points, size_t n)
+{
+    T e = s.radius * T (1e-5) + T (1e-6);
+
+    for (size_t i = 0; i < n; ++i)
+        if ((points[i] - s.center).length() > s.radius + e)
+            return false;
+
+    return true;
+}
+
+//
+// The minimal sphere, by trying the spheres through all sets of two,
+// three and four points.
+//
+
+template <class T>
+T
+minimalRadius (const std::vector<Vec3<T>>& p)
+{
+    const size_t n = p.size();
+    T best         = std::numeric_limits<T>::infinity();
+
+    auto consider = [&] (const Sphere3<T>& s) {
+        if (s.radius < best && encloses (s, &p[0], n))
+            best = s.radius;
+    };
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        for (size_t j = i + 1; j < n; ++j)
+        {
+            consider (sphereThrough (p[i], p[j]));
+
+            for (size_t k = j + 1; k < n; ++k)
+            {
+                consider (sphereThrough (p[i], p[j], p[k]));
+
+                for (size_t l = k + 1; l < n; ++l)
+                    consider (sphereThrough (p[i], p[j], p[k], p[l]));
+            }
+        }
+    }
+
+    return best;
+}
+
+template <class T>
+void
+testExtendBy()
+{
+    Sphere3<T> s (Vec3<T> (0), 1);
+
+    s.extendBy (Vec3<T> (0, T (0.5), 0));
+    assert (s.center == Vec3<T> (0) && s.radius == 1);
+
+    s.extendBy (Vec3<T> (3, 0, 0));
+    assert (s.center == Vec3<T> (1, 0, 0) && s.radius == 2);
+
+    s.extendBy (Sphere3<T> (Vec3<T> (1, 1, 0), T (0.5)));
+    assert (s.center == Vec3<T> (1, 0, 0) && s.radius == 2);
+
+    s.extendBy (Sphere3<T> (Vec3<T> (1, 1, 0), 4));
+    assert (s.center == Vec3<T> (1, 1, 0) && s.radius == 4);
+
+    s.extendBy (Sphere3<T> (Vec3<T> (1, 7, 0), 2));
+    assert (s.center == Vec3<T> (1, 3, 0) && s.radius == 6);
+}
+
+template <class T>
+void
+testCircumscribe()
+{
+    Rand48 rand (0);
+
+    //
+    // Special cases: no points, coincident, collinear and coplanar
+    // points, and the vertices of a cube.
+    //
+
+    Sphere3<T> s (Vec3<T> (1), 1);
+
+    s.circumscribe (nullptr, 0);
+    assert (s.center == Vec3<T> (0) && s.radius == 0);
+
+    s = Sphere3<T> (Vec3<T> (1), 1);
+    s.circumscribeMinimal (nullptr, 0);
+    assert (s.center == Vec3<T> (0) && s.radius == 0);
+
+    std::vector<Vec3<T>> points (5, Vec3<T> (1, 2, 3));
+
+    s.circumscribe (&points[0], points.size());
+    assert (s.center == Vec3<T> (1, 2, 3) && s.radius == 0);
+
+    s.circumscribeMinimal (&points[0], points.size());
+    assert (s.center == Vec3<T> (1, 2, 3) && s.radius == 0);
+
+    for (size_t i = 0; i < points.size(); ++i)
+        points[i] = Vec3<T> (T (i * 2), 0, 1);
+
+    s.circumscribeMinimal (&points[0], points.size());
+    assert (s.center.equalWithAbsError (Vec3<T> (4, 0, 1), T (1e-5)));
+    assert (equalWithAbsError (s.radius, T (4), T (1e-5)));
+
+    points = { Vec3<T> (0, 0, 1), Vec3<T> (2, 0, 1), Vec3<T> (2, 2, 1), Vec3<T> (0, 2, 1), Vec3<T> (1, 1, 1) };
+
+    s.circumscribeMinimal (&points[0], points.size());
+    assert (s.center.equalWithAbsError (Vec3<T> (1, 1, 1), T (1e-5)));
+    assert (equalWithAbsError (s.radius, T (std::sqrt (2.0)), T (1e-5)));
+
+    points.clear();
+
+    for (int i = 0; i < 8; ++i)
+        points.push_back (Vec3<T> (T (i & 1), T ((i >> 1) & 1), T ((i >> 2) & 1)));
+
+    s.circumscribe (&points[0], points.size());
+    assert (s.center.equalWithAbsError (Vec3<T> (T (0.5)), T (1e-5)));
+    assert (equalWithAbsError (s.radius, T (std::sqrt (0.75)), T (1e-5)));
+
+    s.circumscribeMinimal (&points[0], points.size());
+    assert (s.center.equalWithAbsError (Vec3<T> (T (0.5)), T (1e-5)));
+    assert (equalWithAbsError (s.radius, T (std::sqrt (0.75)), T (1e-5)));
+
+    //
+    // Small random sets, against all the candidate spheres
+    //
+
+    for (int q = 0; q < 200; ++q)
+    {
+        points.resize (2 + q % 11);
+
+        for (size_t i = 0; i < points.size(); ++i)
+            points[i] = Vec3<T> (rand.nextf (-5, 5), rand.nextf (-5, 5), rand.nextf (-5, 5));
+
+        if (q % 4 == 0)
+        {
+            for (size_t i = 0; i < points.size(); ++i)
+                points[i].z = 0;
+        }
+
+        T r = minimalRadius (points);
+
+        s.circumscribeMinimal (&points[0], points.size());
+        assert (encloses (s, &points[0], points.size()));
+        assert (equalWithRelError (s.radius, r, T (1e-4)));
+
+        s.circumscribe (&points[0], points.size());
+        assert (encloses (s, &points[0], points.size()));
+        assert (s.radius >= r * T (0.9999));
+    }
+
+    //
+    // Large sets, in a ball and in a flattened box, in sorted order,
+    // and the combination of the spheres of parts of a set.
+    //
+
+    points.resize (10000);
+
+    for (int q = 0; q < 4; ++q)
+    {
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            points[i] = solidSphereRand<Vec3<T>> (rand) * T (10);
+
+            if (q & 1)
+                points[i] = Vec3<T> (rand.nextf (-8, 8), rand.nextf (-3, 3), rand.nextf (-1, 1));
+        }
+
+        if (q & 2)
+        {
+            std::sort (points.begin(), points.end(), [] (const Vec3<T>& a, const Vec3<T>& b) {
+                return a.x < b.x;
+            });
+        }
+
+        Sphere3<T> minimal, ritter;
+        minimal.circumscribeMinimal (&points[0], points.size());
+        ritter.circumscribe (&points[0], points.size());
+
+        assert (encloses (minimal, &points[0], points.size()));
+        assert (encloses (ritter, &points[0], points.size()));
+        assert (minimal.radius <= ritter.radius && ritter.radius < minimal.radius * T (1.2));
+
+        Sphere3<T> part;
+        part.circumscribe (&points[0], 3000);
+        s.circumscribe (&points[3000], points.size() - 3000);
+        s.extendBy (part);
+
+        assert (encloses (s, &points[0], points.size()));
+    }
+}
+
+} // namespace
+
+void
+testSphere()
+{
+    cout << "Testing spheres" << endl;
+
+    cout << "  float" << endl;
+    testExtendBy<float>();
+    testCircumscribe<float>();
+
+    cout << "  double" << endl;
+    testExtendBy<double>();
+    testCircumscribe<double>();
+
+    cout << "ok\n" << endl;
+}
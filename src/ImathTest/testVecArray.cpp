@@ -0,0 +1,249 @@
+//
+// SPDX-License-Identifier: BSD-3-Clause
+// Copyright Contributors to the OpenEXR Project.
+//
+
+#ifdef NDEBUG
+#    undef NDEBUG
+#endif
+
+#include <ImathRandom.h>
+#include <ImathVecArray.h>
+#include <assert.h>
+#include <iostream>
+#include <limits>
+#include <stdint.h>
+#include <vector>
+#include "testVecArray.h"
+
+using namespace std;
+using namespace IMATH_INTERNAL_NAMESPACE;
+
+namespace
+{
+
+template <class T>
+bool
+aligned (const T* p)
+{
+    return reinterpret_cast<uintptr_t> (p) % 64 == 0;
+}
+
+template <class T>
+std::vector<Vec3<T>>
+randomVectors (Rand48& rand, size_t n)
+{
+    std::vector<Vec3<T>> v (n);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = Vec3<T> (rand.nextf (-10, 10), rand.nextf (-10, 10), rand.nextf (-10, 10));
+
+    return v;
+}
+
+template <class T>
+void
+testStorage()
+{
+    Rand48 rand (0);
+
+    Vec3Array<T> empty;
+    assert (empty.size() == 0);
+
+    Vec3Array<T> zeros (5);
+    assert (zeros.size() == 5);
+
+    for (size_t i = 0; i < 5; ++i)
+        assert (zeros[i] == Vec3<T> (0));
+
+    for (size_t n = 1; n < 40; n += 3)
+    {
+        std::vector<Vec3<T>> v = randomVectors<T> (rand, n);
+
+        Vec3Array<T> a (&v[0], n);
+
+        assert (a.size() == n);
+        assert (aligned (a.x()) && aligned (a.y()) && aligned (a.z()));
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            assert (a[i] == v[i]);
+            assert (a.x()[i] == v[i].x);
+            assert (a.y()[i] == v[i].y);
+            assert (a.z()[i] == v[i].z);
+        }
+
+        //
+        // Copies, moves and round trips through arrays of Vec3.
+        //
+
+        Vec3Array<T> b (a);
+        assert (aligned (b.x()) && aligned (b.y()) && aligned (b.z()));
+
+        std::vector<Vec3<T>> w (n);
+        b.copyTo (&w[0]);
+        assert (w == v);
+
+        Vec3Array<T> c (std::move (b));
+        assert (c.size() == n && b.size() == 0);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (c[i] == v[i]);
+
+        c.set (0, Vec3<T> (1, 2, 3));
+        assert (c[0] == Vec3<T> (1, 2, 3));
+        assert (a[0] == v[0]);
+
+        c = a;
+        assert (c[0] == v[0]);
+
+        //
+        // Resizing preserves the existing vectors.
+        //
+
+        c.resize (n + 7);
+        assert (c.size() == n + 7);
+        assert (aligned (c.x()) && aligned (c.y()) && aligned (c.z()));
+
+        for (size_t i = 0; i < n + 7; ++i)
+            assert (c[i] == (i < n ? v[i] : Vec3<T> (0)));
+
+        c.resize (n / 2);
+
+        for (size_t i = 0; i < n / 2; ++i)
+            assert (c[i] == v[i]);
+
+        //
+        // The free transposition functions.
+        //
+
+        std::vector<T> x (n), y (n), z (n);
+        aosToSoa (&v[0], n, &x[0], &y[0], &z[0]);
+
+        for (size_t i = 0; i < n; ++i)
+            assert (Vec3<T> (x[i], y[i], z[i]) == v[i]);
+
+        soaToAos (&x[0], &y[0], &z[0], n, &w[0]);
+        assert (w == v);
+    }
+}
+
+template <class T>
+void
+testOperations()
+{
+    Rand48 rand (1);
+
+    const size_t n = 1000;
+
+    std::vector<Vec3<T>> u = randomVectors<T> (rand, n);
+    std::vector<Vec3<T>> v = randomVectors<T> (rand, n);
+
+    //
+    // Include null and tiny vectors, whose squared lengths underflow.
+    //
+
+    const T tiny = std::numeric_limits<T>::min();
+
+    u[3]  = Vec3<T> (0);
+    u[17] = Vec3<T> (tiny, 0, 0);
+    u[18] = Vec3<T> (tiny, -tiny, tiny);
+    u[19] = Vec3<T> (0, 0, std::numeric_limits<T>::denorm_min());
+
+    Vec3Array<T> a (&u[0], n);
+    Vec3Array<T> b (&v[0], n);
+
+    std::vector<T> result (n);
+
+    //
+    // The loops may be contracted into fused multiply-adds
+    // differently from the scalar functions.
+    //
+
+    const T e = 1000 * std::numeric_limits<T>::epsilon();
+
+    a.dot (b, &result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equalWithAbsError (result[i], u[i].dot (v[i]), e));
+
+    a.length (&result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equalWithAbsError (result[i], u[i].length(), e));
+
+    a.length2 (&result[0]);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (equalWithAbsError (result[i], u[i].length2(), e));
+
+    Vec3Array<T> c;
+    a.cross (b, c);
+    assert (c.size() == n);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i].cross (v[i]), e));
+
+    c = a;
+    c.cross (b, c);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i].cross (v[i]), e));
+
+    c = a;
+    c += b;
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i] + v[i], e));
+
+    c = a;
+    c -= b;
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i] - v[i], e));
+
+    c = a;
+    c *= b;
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i] * v[i], e));
+
+    c = a;
+    c *= T (3);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i] * T (3), e));
+
+    c = a;
+    c /= T (3);
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i] / T (3), e));
+
+    c = a;
+    c.normalize();
+
+    for (size_t i = 0; i < n; ++i)
+        assert (c[i].equalWithAbsError (u[i].normalized(), e));
+
+    assert (c[3] == Vec3<T> (0));
+    assert (c[17] == Vec3<T> (1, 0, 0));
+}
+
+} // namespace
+
+void
+testVecArray()
+{
+    cout << "Testing arrays of vectors" << endl;
+
+    cout << "  storage and conversions" << endl;
+    testStorage<float>();
+    testStorage<double>();
+
+    cout << "  operations" << endl;
+    testOperations<float>();
+    testOperations<double>();
+
+    cout << "ok\n" << endl;
+}